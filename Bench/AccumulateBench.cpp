@@ -0,0 +1,88 @@
+#include "Bench/BenchUtil.h"
+#include "Core/TrailAccumulator.h"
+#include <cmath>
+#include <cstdio>
+
+// Steady-state frame cost of continuous circular cursor motion on a 1920x1080 surface,
+// redrawing the whole trail each frame vs fading the previous frame and stamping only
+// new motion. One sample per 240 Hz frame, 32x32 cursor, 200 px radius.
+int main()
+{
+    Sprite sprite;
+    sprite.w = sprite.h = 32;
+    sprite.hotX = sprite.hotY = 0;
+    sprite.px.resize(static_cast<size_t>(sprite.w) * sprite.h);
+    for (int y = 0; y < sprite.h; ++y)
+    {
+        for (int x = 0; x < sprite.w; ++x)
+        {
+            const uint32_t a = (x + y < 40) ? 255u : 0u;
+            sprite.px[static_cast<size_t>(y) * sprite.w + x] = (a << 24) | (a << 16) | (a << 8) | a;
+        }
+    }
+
+    struct Case { const char* name; float revPerSec; float fadeMs; };
+    const Case cases[] = { { "slow", 0.5f, 50.f }, { "fast", 2.f, 50.f }, { "fast", 2.f, 200.f }, { "spin", 6.f, 200.f } };
+
+    constexpr int kWarmupFrames = 240;
+    constexpr int kFrames = 2400;
+    const auto frameDt = std::chrono::microseconds(4167);
+
+    std::printf("%-6s %6s %-10s %12s %14s %14s %10s\n", "speed", "fadeMs", "mode", "stamps/frm", "blended/frm", "decayed/frm", "us/frame");
+    for (const Case& c : cases)
+    {
+        for (bool accumulate : { false, true })
+        {
+            TrailSettings settings;
+            settings.maxAlpha = 255;
+            settings.fadeMs = c.fadeMs;
+            settings.accumulate = accumulate;
+
+            PixelBuffer dst;
+            dst.Resize(1920, 1080);
+            TrailBuffer trail(kMaxTrailSize);
+            TrailRenderer renderer;
+            TrailAccumulator acc;
+            DamageTracker damage;
+
+            auto now = TrailClock::time_point{} + std::chrono::seconds(1);
+            uint64_t stamps = 0, blended = 0, decayed = 0;
+            BenchClock::duration elapsed{};
+            for (int f = 0; f < kWarmupFrames + kFrames; ++f)
+            {
+                now += frameDt;
+                const float ang = 6.2831853f * c.revPerSec * std::chrono::duration<float>(now.time_since_epoch()).count();
+                UpdateTrail(trail, { 960 + static_cast<int>(200.f * std::cos(ang)), 540 + static_cast<int>(200.f * std::sin(ang)) },
+                    now, settings);
+
+                const auto start = BenchClock::now();
+                TrailRenderStats stats;
+                if (accumulate)
+                {
+                    stats = acc.Render(dst.View(), sprite, trail, 0, 0, now, settings);
+                }
+                else
+                {
+                    ClearRect(dst.View(), damage.PendingClear(dst.w, dst.h));
+                    stats = renderer.Render(dst.View(), sprite, trail, 0, 0, now, settings);
+                    damage.EndFrame(stats.bounds, dst.w, dst.h);
+                }
+                DoNotOptimize(stats);
+
+                if (f >= kWarmupFrames)
+                {
+                    elapsed += BenchClock::now() - start;
+                    stamps += stats.stamps;
+                    blended += stats.pixelsBlended;
+                    decayed += stats.pixelsDecayed;
+                }
+            }
+
+            std::printf("%-6s %6.0f %-10s %12llu %14llu %14llu %10.1f\n", c.name, c.fadeMs, accumulate ? "accumulate" : "redraw",
+                static_cast<unsigned long long>(stamps / kFrames), static_cast<unsigned long long>(blended / kFrames),
+                static_cast<unsigned long long>(decayed / kFrames),
+                std::chrono::duration<double, std::micro>(elapsed).count() / kFrames);
+        }
+    }
+    return 0;
+}
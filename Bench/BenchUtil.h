@@ -0,0 +1,36 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+using BenchClock = std::chrono::steady_clock;
+
+// Keeps the optimizer from discarding a computed value
+template<typename T>
+inline void DoNotOptimize(const T& value) noexcept
+{
+#if defined(_MSC_VER)
+    static volatile const void* sink;
+    sink = &value;
+#else
+    asm volatile("" : : "g"(&value) : "memory");
+#endif
+}
+
+// Runs fn repeatedly for at least minMs and returns the mean nanoseconds per call
+template<typename Fn>
+inline double MeasureNsPerCall(Fn&& fn, double minMs = 200.0)
+{
+    fn(); // Warm-up
+    uint64_t calls = 0;
+    const auto start = BenchClock::now();
+    auto elapsed = BenchClock::duration::zero();
+    do
+    {
+        for (int i = 0; i < 16; ++i)
+            fn();
+        calls += 16;
+        elapsed = BenchClock::now() - start;
+    } while (std::chrono::duration<double, std::milli>(elapsed).count() < minMs);
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(calls);
+}
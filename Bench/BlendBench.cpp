@@ -0,0 +1,43 @@
+#include "Bench/BenchUtil.h"
+#include "Core/Blend.h"
+#include "Core/Compositor.h"
+#include <cstdio>
+
+// Blends a cursor-sized sprite across a 1080p surface with each kernel variant
+int main()
+{
+    PixelBuffer dst;
+    dst.Resize(1920, 1080);
+
+    Sprite sprite;
+    sprite.w = sprite.h = 48;
+    sprite.px.resize(static_cast<size_t>(sprite.w) * sprite.h);
+    for (size_t i = 0; i < sprite.px.size(); ++i)
+    {
+        const uint32_t a = static_cast<uint32_t>(i * 7) & 0xFF;
+        sprite.px[i] = (a << 24) | (a << 16) | ((a / 2) << 8) | (a / 3);
+    }
+
+    const SurfaceView view = dst.View();
+    std::printf("%-8s %12s\n", "kernel", "Mpixels/s");
+    for (int k = 0; k < static_cast<int>(BlendKernel::Count); ++k)
+    {
+        const BlendKernel kernel = static_cast<BlendKernel>(k);
+        if (!SetActiveBlendKernel(kernel))
+            continue;
+
+        uint64_t pixels = 0;
+        int x = 0;
+        const double ns = MeasureNsPerCall([&]
+        {
+            pixels = BlendSprite(view, sprite, x, (x * 3) % 1000, 96);
+            x = (x + 37) % 1800;
+        });
+        DoNotOptimize(dst.px[0]);
+
+        std::printf("%-8s %12.1f\n", BlendKernelName(kernel), static_cast<double>(pixels) * 1e3 / ns);
+    }
+
+    SetActiveBlendKernel(BestBlendKernel());
+    return 0;
+}
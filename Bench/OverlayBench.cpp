@@ -0,0 +1,67 @@
+#include "Bench/BenchUtil.h"
+#include "Core/Compositor.h"
+#include "Core/SurfacePool.h"
+#include <cmath>
+#include <cstdio>
+
+// Compares resident surface memory and per-frame clear+render cost of the
+// full virtual-screen surface against a trail-sized pooled surface
+int main()
+{
+    constexpr int kScreenW = 3 * 3840, kScreenH = 2160; // Triple 4K
+    constexpr double kPi = 3.14159265358979;
+
+    Sprite sprite;
+    sprite.w = sprite.h = 32;
+    sprite.px.assign(static_cast<size_t>(sprite.w) * sprite.h, 0xFFFFFFFFu);
+
+    TrailSettings settings;
+    settings.maxAlpha = 64;
+    settings.sensitivity = 0.1f;
+
+    // Circular motion, one sample per 4 ms
+    TrailBuffer trail(kMaxTrailSize);
+    const auto t0 = TrailClock::time_point{} + std::chrono::seconds(1);
+    auto now = t0;
+    int frame = 0;
+    auto Advance = [&]
+    {
+        const double ang = frame++ * 0.12;
+        now += std::chrono::milliseconds(4);
+        UpdateTrail(trail, { 1900 + static_cast<int>(300 * std::cos(ang)), 1000 + static_cast<int>(300 * std::sin(ang)) },
+            now, settings);
+    };
+    for (int i = 0; i < 64; ++i)
+        Advance();
+
+    PixelBuffer full;
+    full.Resize(kScreenW, kScreenH);
+    const double fullNs = MeasureNsPerCall([&]
+    {
+        Advance();
+        ClearSurface(full.View());
+        RenderTrail(full.View(), sprite, trail, 0, 0, now, settings);
+    });
+
+    SurfacePool<PixelBuffer> pool;
+    const double followNs = MeasureNsPerCall([&]
+    {
+        Advance();
+        const PixelRect area = TrailBounds(trail, sprite);
+        PixelBuffer* surf = pool.Acquire(area.Width(), area.Height(), [](PixelBuffer& b, int w, int h)
+        {
+            b.Resize(w, h);
+            return true;
+        });
+        const SurfaceView view{ surf->px.data(), area.Width(), area.Height(), surf->w };
+        ClearSurface(view);
+        RenderTrail(view, sprite, trail, area.left, area.top, now, settings);
+    });
+
+    std::printf("%-12s %14s %14s\n", "mode", "surface MB", "us/frame");
+    std::printf("%-12s %14.2f %14.2f\n", "fullscreen",
+        static_cast<double>(full.px.size()) * 4 / (1024.0 * 1024.0), fullNs / 1e3);
+    std::printf("%-12s %14.2f %14.2f\n", "follow",
+        static_cast<double>(pool.Bytes()) / (1024.0 * 1024.0), followNs / 1e3);
+    return 0;
+}
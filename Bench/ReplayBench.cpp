@@ -0,0 +1,266 @@
+#include "Bench/BenchUtil.h"
+#include "Core/SyntheticTrace.h"
+#include "Core/TraceFile.h"
+#include "Core/TrailAccumulator.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Headless frame-by-frame replay of cursor traces through UpdateTrail and the compositor
+// into an offscreen surface, on a simulated clock so results do not depend on the pace
+// of the machine. Runs every synthetic pattern by default, or a trace recorded with the
+// overlay's record argument. Exits non-zero when any p99 frame time exceeds
+// --max-p99-us, so it can gate regressions.
+struct ReplayOptions final
+{
+    int width = 1920, height = 1080;
+    int cursor = 32;              // Cursor sprite edge in px
+    int durationMs = 5000;        // Synthetic trace length
+    int fps = 240;                // Simulated display refresh
+    std::vector<TracePattern> patterns;
+    const char* tracePath = nullptr;
+    double maxP99Us = 0;          // 0 = no gate
+    bool json = false;
+    TrailSettings settings;
+};
+
+struct ReplayResult final
+{
+    int frames = 0;
+    double totalNs = 0;
+    double p99Ns = 0;
+    double maxNs = 0;
+    uint64_t stamps = 0;
+    uint64_t stampsGenerated = 0; // Before coalescing and culling
+    uint64_t pixelsBlended = 0;
+};
+
+static void PrintUsage()
+{
+    std::printf(
+        "usage: ReplayBench [options]\n"
+        "  --size WxH             offscreen surface size (1920x1080)\n"
+        "  --cursor N             cursor sprite size in px (32)\n"
+        "  --pattern NAME         lines|circles|flicks|jitter|idle, repeatable (all)\n"
+        "  --trace PATH           replay a recorded trace file instead\n"
+        "  --duration MS          synthetic trace length (5000)\n"
+        "  --fps N                simulated frame rate (240)\n"
+        "  --renderer stamp|swept|subpixel (stamp)\n"
+        "  --spacing PX           px between subpixel stamps (2)\n"
+        "  --history redraw|accumulate (redraw)\n"
+        "  --coalesce --cull N    merge same-position stamps, drop merged stamps below alpha N (off, 0)\n"
+        "  --error N              widen steps while stamps stay below alpha N (0 = one per pixel)\n"
+        "  --fade MS --alpha N    trail settings (50, 255)\n"
+        "  --max-p99-us N         fail when a p99 frame time exceeds N us\n"
+        "  --json                 one JSON object per trace instead of a table\n");
+}
+
+static bool ParseArgs(int argc, char** argv, ReplayOptions& opt)
+{
+    opt.settings.maxAlpha = 255;
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        const char* val = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        auto takes = [&]() { if (!val) return false; ++i; return true; };
+
+        if (!std::strcmp(arg, "--json"))
+            opt.json = true;
+        else if (!std::strcmp(arg, "--size") && takes())
+        {
+            if (std::sscanf(val, "%dx%d", &opt.width, &opt.height) != 2 || opt.width <= 0 || opt.height <= 0)
+                return false;
+        }
+        else if (!std::strcmp(arg, "--cursor") && takes())
+            opt.cursor = std::clamp(std::atoi(val), 1, 256);
+        else if (!std::strcmp(arg, "--pattern") && takes())
+        {
+            TracePattern p;
+            if (!ParseTracePattern(val, p))
+                return false;
+            opt.patterns.push_back(p);
+        }
+        else if (!std::strcmp(arg, "--trace") && takes())
+            opt.tracePath = val;
+        else if (!std::strcmp(arg, "--duration") && takes())
+            opt.durationMs = std::max(std::atoi(val), 1);
+        else if (!std::strcmp(arg, "--fps") && takes())
+            opt.fps = std::clamp(std::atoi(val), 1, 2000);
+        else if (!std::strcmp(arg, "--renderer") && takes())
+            opt.settings.method = !std::strcmp(val, "swept") ? RenderMethod::Swept
+                : !std::strcmp(val, "subpixel") ? RenderMethod::Subpixel : RenderMethod::Stamp;
+        else if (!std::strcmp(arg, "--spacing") && takes())
+            opt.settings.stampSpacing = std::clamp(static_cast<float>(std::atof(val)), 0.25f, 8.f);
+        else if (!std::strcmp(arg, "--history") && takes())
+            opt.settings.accumulate = !std::strcmp(val, "accumulate");
+        else if (!std::strcmp(arg, "--fade") && takes())
+            opt.settings.fadeMs = std::max(static_cast<float>(std::atof(val)), 1.f);
+        else if (!std::strcmp(arg, "--alpha") && takes())
+            opt.settings.maxAlpha = static_cast<uint8_t>(std::clamp(std::atoi(val), 0, 255));
+        else if (!std::strcmp(arg, "--coalesce"))
+            opt.settings.coalesce = true;
+        else if (!std::strcmp(arg, "--cull") && takes())
+            opt.settings.cullAlpha = static_cast<uint8_t>(std::clamp(std::atoi(val), 0, 255));
+        else if (!std::strcmp(arg, "--error") && takes())
+            opt.settings.errorBudget = static_cast<uint8_t>(std::clamp(std::atoi(val), 0, 255));
+        else if (!std::strcmp(arg, "--max-p99-us") && takes())
+            opt.maxP99Us = std::atof(val);
+        else
+            return false;
+    }
+    if (opt.patterns.empty())
+    {
+        for (int i = 0; i < static_cast<int>(TracePattern::Count); ++i)
+            opt.patterns.push_back(static_cast<TracePattern>(i));
+    }
+    return true;
+}
+
+// Opaque white arrow-ish cursor: a right triangle anchored at the hotspot
+static Sprite MakeCursor(int size)
+{
+    Sprite sprite;
+    sprite.w = sprite.h = size;
+    sprite.px.resize(static_cast<size_t>(size) * size);
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            const uint32_t a = (x <= y && x + y < size * 5 / 4) ? 255u : 0u;
+            sprite.px[static_cast<size_t>(y) * size + x] = (a << 24) | (a << 16) | (a << 8) | a;
+        }
+    }
+    return sprite;
+}
+
+static ReplayResult Replay(const std::vector<TraceSample>& trace, const Sprite& sprite, const ReplayOptions& opt)
+{
+    ReplayResult r;
+    PixelBuffer dst;
+    dst.Resize(opt.width, opt.height);
+    TrailBuffer trail(kMaxTrailSize);
+    TrailRenderer renderer;
+    TrailAccumulator acc;
+    DamageTracker damage;
+
+    // Frames run until the last sample has fully faded
+    const int64_t frameUs = 1000000 / opt.fps;
+    const int64_t endUs = (trace.empty() ? 0 : trace.back().us) + static_cast<int64_t>(opt.settings.fadeMs * 1000.f) + frameUs;
+    const auto epoch = TrailClock::time_point{} + std::chrono::seconds(1);
+
+    std::vector<double> frameNs;
+    frameNs.reserve(static_cast<size_t>(endUs / frameUs) + 1);
+    size_t next = 0;
+    for (int64_t us = 0; us <= endUs; us += frameUs)
+    {
+        const auto now = epoch + std::chrono::microseconds(us);
+        const auto start = BenchClock::now();
+
+        for (; next < trace.size() && trace[next].us <= us; ++next)
+            UpdateTrail(trail, trace[next].pt, epoch + std::chrono::microseconds(trace[next].us), opt.settings);
+        ExpireTrail(trail, now, opt.settings);
+
+        TrailRenderStats stats;
+        if (opt.settings.accumulate)
+        {
+            stats = acc.Render(dst.View(), sprite, trail, 0, 0, now, opt.settings);
+        }
+        else
+        {
+            ClearRect(dst.View(), damage.PendingClear(dst.w, dst.h));
+            stats = renderer.Render(dst.View(), sprite, trail, 0, 0, now, opt.settings);
+            damage.EndFrame(stats.bounds, dst.w, dst.h);
+        }
+        DoNotOptimize(stats);
+
+        frameNs.push_back(std::chrono::duration<double, std::nano>(BenchClock::now() - start).count());
+        r.stamps += stats.stamps;
+        r.stampsGenerated += static_cast<uint64_t>(stats.stamps) + static_cast<uint64_t>(stats.stampsCoalesced);
+        r.pixelsBlended += stats.pixelsBlended;
+    }
+
+    r.frames = static_cast<int>(frameNs.size());
+    for (double ns : frameNs)
+        r.totalNs += ns;
+    const size_t p99 = std::min(frameNs.size() - 1, frameNs.size() * 99 / 100);
+    std::nth_element(frameNs.begin(), frameNs.begin() + p99, frameNs.end());
+    r.p99Ns = frameNs[p99];
+    r.maxNs = *std::max_element(frameNs.begin() + p99, frameNs.end());
+    return r;
+}
+
+int main(int argc, char** argv)
+{
+    ReplayOptions opt;
+    if (!ParseArgs(argc, argv, opt))
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    struct Named { std::string name; std::vector<TraceSample> trace; };
+    std::vector<Named> traces;
+    if (opt.tracePath)
+    {
+        Named n{ opt.tracePath, {} };
+        if (!LoadTraceFile(opt.tracePath, n.trace) || n.trace.empty())
+        {
+            std::fprintf(stderr, "ReplayBench: cannot read trace %s\n", opt.tracePath);
+            return 2;
+        }
+        traces.push_back(std::move(n));
+    }
+    else
+    {
+        for (TracePattern p : opt.patterns)
+            traces.push_back({ TracePatternName(p), MakeSyntheticTrace(p, opt.width, opt.height, opt.durationMs) });
+    }
+
+    const Sprite sprite = MakeCursor(opt.cursor);
+    const char* method = opt.settings.method == RenderMethod::Swept ? "swept"
+        : opt.settings.method == RenderMethod::Subpixel ? "subpixel" : "stamp";
+    const char* history = opt.settings.accumulate ? "accumulate" : "redraw";
+    if (!opt.json)
+    {
+        std::printf("%dx%d, %dpx cursor, %d fps, %s/%s, fade %.0f ms, alpha %d, coalesce %s, cull %d, spacing %.2f, error %d\n", opt.width,
+            opt.height, opt.cursor, opt.fps, method, history, opt.settings.fadeMs, opt.settings.maxAlpha,
+            opt.settings.coalesce ? "on" : "off", opt.settings.cullAlpha, opt.settings.stampSpacing,
+            opt.settings.errorBudget);
+        std::printf("%-10s %7s %10s %10s %10s %10s %12s %12s %14s\n", "trace", "frames", "frames/s", "ns/frame", "p99 us",
+            "max us", "stepped/frm", "stamps/frm", "blended/frm");
+    }
+
+    bool pass = true;
+    for (const Named& n : traces)
+    {
+        const ReplayResult r = Replay(n.trace, sprite, opt);
+        const double nsPerFrame = r.totalNs / r.frames;
+        const double fps = r.totalNs > 0 ? 1e9 / nsPerFrame : 0;
+        if (opt.json)
+        {
+            std::printf("{\"trace\":\"%s\",\"width\":%d,\"height\":%d,\"cursor\":%d,\"renderer\":\"%s\",\"history\":\"%s\","
+                "\"frames\":%d,\"fps\":%.1f,\"nsPerFrame\":%.0f,\"p99Us\":%.2f,\"maxUs\":%.2f,\"stampsGenerated\":%llu,\"stamps\":%llu,\"pixelsBlended\":%llu}\n",
+                n.name.c_str(), opt.width, opt.height, opt.cursor, method, history, r.frames, fps, nsPerFrame,
+                r.p99Ns / 1000.0, r.maxNs / 1000.0, static_cast<unsigned long long>(r.stampsGenerated),
+                static_cast<unsigned long long>(r.stamps),
+                static_cast<unsigned long long>(r.pixelsBlended));
+        }
+        else
+        {
+            std::printf("%-10s %7d %10.0f %10.0f %10.1f %10.1f %12llu %12llu %14llu\n", n.name.c_str(), r.frames, fps,
+                nsPerFrame, r.p99Ns / 1000.0, r.maxNs / 1000.0, static_cast<unsigned long long>(r.stampsGenerated / r.frames),
+                static_cast<unsigned long long>(r.stamps / r.frames),
+                static_cast<unsigned long long>(r.pixelsBlended / r.frames));
+        }
+
+        if (opt.maxP99Us > 0 && r.p99Ns / 1000.0 > opt.maxP99Us)
+        {
+            std::fprintf(stderr, "ReplayBench: %s p99 %.1f us exceeds %.1f us\n", n.name.c_str(), r.p99Ns / 1000.0, opt.maxP99Us);
+            pass = false;
+        }
+    }
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+#include "Bench/BenchUtil.h"
+#include "Core/Stats.h"
+#include <cstdio>
+
+// Cost of the instrumentation left in the frame loop: a scoped stage timer plus three
+// counter updates, with stats disabled (the default) and enabled
+int main()
+{
+    std::printf("%-10s %12s\n", "stats", "ns/frame");
+    for (bool enabled : { false, true })
+    {
+        SetStatsEnabled(enabled);
+        uint64_t work = 0;
+        const double ns = MeasureNsPerCall([&]
+        {
+            ScopedStageTimer timer(StatStage::Composite);
+            AddCounter(StatCounter::Stamps, 31);
+            AddCounter(StatCounter::PixelsBlended, 31 * 1024);
+            AddCounter(StatCounter::Frames);
+            DoNotOptimize(++work);
+        });
+        std::printf("%-10s %12.1f\n", enabled ? "enabled" : "disabled", ns);
+    }
+    SetStatsEnabled(false);
+    return 0;
+}
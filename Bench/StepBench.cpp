@@ -0,0 +1,72 @@
+#include "Bench/BenchUtil.h"
+#include "Core/TrailStepper.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// Reference: the original per-step float interpolation and fade math
+template<typename Fn>
+static void FloatStepSegment(TrailPoint p0, TrailPoint p1, int ageMs, const TrailSettings& settings, Fn&& fn)
+{
+    const float age0 = static_cast<float>(ageMs);
+    const float dx = static_cast<float>(p1.x - p0.x);
+    const float dy = static_cast<float>(p1.y - p0.y);
+    const float distSq = dx * dx + dy * dy;
+    if (distSq < 1.f)
+        return;
+
+    const float dist = std::sqrt(distSq);
+    const int steps = static_cast<int>(std::ceil(dist));
+    const float stepFrac = 1.f / static_cast<float>(steps);
+    for (int j = steps; j >= 0; --j)
+    {
+        const float t = j * stepFrac;
+        const int px = static_cast<int>(std::lround(p0.x + dx * t));
+        const int py = static_cast<int>(std::lround(p0.y + dy * t));
+        const float fade = std::max(0.f, 1.f - (age0 + (age0 * t * 0.1f)) / settings.fadeMs);
+        const float speedFactor = std::clamp(dist * settings.sensitivity, 0.f, 1.f);
+        fn(px, py, static_cast<uint8_t>(std::clamp(settings.maxAlpha * fade * speedFactor, 0.f, 255.f)));
+    }
+}
+
+// Per-step cost of walking trail segments (position and alpha only, no blending) for
+// short, medium and long segments in 16 directions at ages spread across the fade window
+int main()
+{
+    TrailSettings settings;
+    settings.maxAlpha = 255;
+    TrailAlphaLut lut;
+    lut.Update(settings);
+
+    std::printf("%-8s %10s %10s %10s\n", "segment", "float ns", "lut ns", "speedup");
+    for (int len : { 4, 16, 64, 256 })
+    {
+        TrailPoint ends[16];
+        int totalSteps = 0;
+        for (int k = 0; k < 16; ++k)
+        {
+            const float a = 6.2831853f * k / 16.f + 0.1f;
+            ends[k] = { 1000 + static_cast<int>(std::lround(len * std::cos(a))), 500 + static_cast<int>(std::lround(len * std::sin(a))) };
+            const int ddx = ends[k].x - 1000, ddy = ends[k].y - 500;
+            totalSteps += static_cast<int>(std::ceil(std::sqrt(static_cast<float>(ddx * ddx + ddy * ddy)))) + 1;
+        }
+
+        uint32_t sink = 0;
+        auto consume = [&](int x, int y, uint8_t a) { sink += static_cast<uint32_t>(x ^ y) + a; };
+        const double floatNs = MeasureNsPerCall([&]
+        {
+            for (int k = 0; k < 16; ++k)
+                FloatStepSegment({ 1000, 500 }, ends[k], k * 3, settings, consume);
+            DoNotOptimize(sink);
+        }) / totalSteps;
+        const double lutNs = MeasureNsPerCall([&]
+        {
+            for (int k = 0; k < 16; ++k)
+                StepSegment({ 1000, 500 }, ends[k], k * 3, lut, consume);
+            DoNotOptimize(sink);
+        }) / totalSteps;
+
+        std::printf("%-8d %10.2f %10.2f %9.1fx\n", len, floatNs, lutNs, floatNs / lutNs);
+    }
+    return 0;
+}
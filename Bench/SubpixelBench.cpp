@@ -0,0 +1,162 @@
+#include "Bench/BenchUtil.h"
+#include "Core/TrailRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Quality and cost of rounded one-pixel stamping against sub-pixel stamping at 1 to 4 px
+// spacing, for a 32x32 cursor drifting slowly (3 px per 4 ms sample) and at medium speed
+// (12 px), 0, 22 and 45 degrees off the horizontal. Error is against a float reference
+// stamping every quarter pixel, which stands in for the continuous path: mean and max
+// absolute channel difference over the pixels either frame touched. Rounding shows up as
+// stair steps along shallow diagonals; wider sub-pixel spacing trades banding for stamps.
+struct Quality final
+{
+    double mean = 0;
+    int max = 0;
+};
+
+static Quality Compare(const PixelBuffer& ref, const PixelBuffer& out)
+{
+    Quality q;
+    size_t touched = 0;
+    for (size_t i = 0; i < ref.px.size(); ++i)
+    {
+        if (!ref.px[i] && !out.px[i])
+            continue;
+        ++touched;
+        for (int c = 0; c < 32; c += 8)
+        {
+            const int d = std::abs(static_cast<int>((ref.px[i] >> c) & 0xFF) - static_cast<int>((out.px[i] >> c) & 0xFF));
+            q.mean += d;
+            q.max = std::max(q.max, d);
+        }
+    }
+    q.mean = touched ? q.mean / static_cast<double>(touched * 4) : 0.0;
+    return q;
+}
+
+// The subpixel method at a quarter pixel spacing without rounding stamp alphas or blends
+static void RenderReference(PixelBuffer& dst, const Sprite& sprite, const TrailBuffer& trail,
+    TrailClock::time_point now, const TrailSettings& settings)
+{
+    std::vector<Sprite> phases;
+    BuildPhaseSprites(sprite, phases);
+    TrailAlphaLut lut;
+    lut.Update(settings);
+    std::vector<float> acc(dst.px.size() * 4, 0.f);
+    const float spacing = 1.f / kSubpixelGrid;
+
+    float offset = 0.f;
+    for (int i = static_cast<int>(trail.Size()) - 2; i >= 0; --i)
+    {
+        const int64_t age0 = (static_cast<int64_t>(trail.ToUs(now)) - trail.TimeUs(i)) / 1000;
+        if (static_cast<float>(age0) > settings.fadeMs)
+            continue;
+        offset = StepSegmentSubpixel(trail.Point(i), trail.Point(i + 1), static_cast<int>(age0), lut, spacing, offset,
+            [&](int xq, int yq, uint8_t a, float)
+        {
+            const float alpha = 1.f - std::pow(1.f - a / 255.f, spacing);
+            const int qx = xq - sprite.hotX * kSubpixelGrid, qy = yq - sprite.hotY * kSubpixelGrid;
+            const int fx = (qx % kSubpixelGrid + kSubpixelGrid) % kSubpixelGrid;
+            const int fy = (qy % kSubpixelGrid + kSubpixelGrid) % kSubpixelGrid;
+            const Sprite& phase = phases[static_cast<size_t>(fy) * kSubpixelGrid + fx];
+            const int x0 = (qx - fx) / kSubpixelGrid, y0 = (qy - fy) / kSubpixelGrid;
+            for (int y = std::max(0, y0); y < std::min(dst.h, y0 + phase.h); ++y)
+            {
+                for (int x = std::max(0, x0); x < std::min(dst.w, x0 + phase.w); ++x)
+                {
+                    const uint32_t p = phase.px[static_cast<size_t>(y - y0) * phase.w + (x - x0)];
+                    float* d = &acc[(static_cast<size_t>(y) * dst.w + x) * 4];
+                    const float keep = 1.f - alpha * static_cast<float>(p >> 24) / 255.f;
+                    for (int c = 0; c < 4; ++c)
+                        d[c] = static_cast<float>((p >> (c * 8)) & 0xFF) * alpha + d[c] * keep;
+                }
+            }
+        });
+    }
+
+    for (size_t i = 0; i < dst.px.size(); ++i)
+    {
+        uint32_t v = 0;
+        for (int c = 0; c < 4; ++c)
+            v |= static_cast<uint32_t>(std::lround(acc[i * 4 + c])) << (c * 8);
+        dst.px[i] = v;
+    }
+}
+
+int main()
+{
+    // Arrow-like cursor with an antialiased diagonal edge
+    Sprite sprite;
+    sprite.w = sprite.h = 32;
+    sprite.px.resize(static_cast<size_t>(sprite.w) * sprite.h);
+    for (int y = 0; y < sprite.h; ++y)
+    {
+        for (int x = 0; x < sprite.w; ++x)
+        {
+            const int edge = 40 - (x + y);
+            const uint32_t a = x > y ? 0u : static_cast<uint32_t>(std::clamp(edge * 128, 0, 255));
+            sprite.px[static_cast<size_t>(y) * sprite.w + x] = (a << 24) | (a << 16) | (a << 8) | a;
+        }
+    }
+
+    TrailSettings settings;
+    settings.maxAlpha = 60;
+    settings.fadeMs = 60.f;
+    settings.sensitivity = 0.1f;
+
+    struct Case { const char* name; float pxPerSample; float degrees; };
+    const Case cases[] = {
+        { "slow", 3.f, 0.f }, { "slow", 3.f, 22.f }, { "slow", 3.f, 45.f },
+        { "medium", 12.f, 0.f }, { "medium", 12.f, 22.f }, { "medium", 12.f, 45.f } };
+    const float spacings[] = { 1.f, 2.f, 3.f, 4.f };
+
+    PixelBuffer ref, out;
+    ref.Resize(640, 480);
+    out.Resize(640, 480);
+    std::printf("%-8s %5s %-12s %8s %12s %10s %8s\n", "speed", "angle", "method", "stamps", "us/frame", "mean err", "max err");
+    for (const Case& c : cases)
+    {
+        const auto now = TrailClock::time_point{} + std::chrono::seconds(1);
+        TrailBuffer trail;
+        const float ang = c.degrees * 3.14159265f / 180.f;
+        for (int i = 14; i >= 0; --i)
+        {
+            const float d = c.pxPerSample * static_cast<float>(14 - i);
+            trail.Push({ 60 + static_cast<int>(std::lround(d * std::cos(ang))), 60 + static_cast<int>(std::lround(d * std::sin(ang))) },
+                now - std::chrono::milliseconds(4 * i));
+        }
+
+        RenderReference(ref, sprite, trail, now, settings);
+        TrailRenderer renderer;
+
+        const auto run = [&](const char* label)
+        {
+            TrailRenderStats stats;
+            const double ns = MeasureNsPerCall([&]
+            {
+                stats = renderer.Render(out.View(), sprite, trail, 0, 0, now, settings);
+                ClearRect(out.View(), stats.bounds);
+            });
+            stats = renderer.Render(out.View(), sprite, trail, 0, 0, now, settings);
+            const Quality q = Compare(ref, out);
+            ClearRect(out.View(), stats.bounds);
+            std::printf("%-8s %5.0f %-12s %8d %12.1f %10.2f %8d\n", c.name, c.degrees, label, stats.stamps, ns / 1e3, q.mean, q.max);
+        };
+
+        settings.method = RenderMethod::Stamp;
+        run("stamp");
+        settings.method = RenderMethod::Subpixel;
+        for (const float s : spacings)
+        {
+            char label[32];
+            std::snprintf(label, sizeof(label), "subpixel %.0f", s);
+            settings.stampSpacing = s;
+            run(label);
+        }
+    }
+    return 0;
+}
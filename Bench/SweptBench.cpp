@@ -0,0 +1,64 @@
+#include "Bench/BenchUtil.h"
+#include "Core/TrailRenderer.h"
+#include <cmath>
+#include <cstdio>
+
+// Frame cost of the stamping vs the swept renderer for a 32x32 cursor moving
+// at slow, medium and flick speeds (one sample every 4 ms), along an axis, 20 degrees
+// off it and on the diagonal. Swept cost follows the area the cursor sweeps, so it
+// gains on long segments in any direction; slow motion is stamped either way.
+int main()
+{
+    Sprite sprite;
+    sprite.w = sprite.h = 32;
+    sprite.px.resize(static_cast<size_t>(sprite.w) * sprite.h);
+    for (int y = 0; y < sprite.h; ++y)
+    {
+        for (int x = 0; x < sprite.w; ++x)
+        {
+            const uint32_t a = (x + y < 40) ? 255u : 0u;
+            sprite.px[static_cast<size_t>(y) * sprite.w + x] = (a << 24) | (a << 16) | (a << 8) | a;
+        }
+    }
+
+    TrailSettings settings;
+    settings.maxAlpha = 255;
+
+    PixelBuffer dst;
+    dst.Resize(3840, 2160);
+
+    struct Case { const char* name; float pxPerSample; float degrees; };
+    const Case cases[] = {
+        { "slow", 2.f, 0.f }, { "medium", 20.f, 0.f }, { "flick", 200.f, 0.f },
+        { "slow", 2.f, 20.f }, { "medium", 20.f, 20.f }, { "flick", 200.f, 20.f },
+        { "slow", 2.f, 45.f }, { "medium", 20.f, 45.f }, { "flick", 200.f, 45.f } };
+
+    std::printf("%-8s %5s %-6s %10s %14s %12s\n", "speed", "angle", "method", "stamps", "px blended", "us/frame");
+    for (const Case& c : cases)
+    {
+        const auto now = TrailClock::time_point{} + std::chrono::seconds(1);
+        TrailBuffer trail;
+        const float ang = c.degrees * 3.14159265f / 180.f;
+        for (int i = 12; i >= 0; --i)
+        {
+            const float d = c.pxPerSample * static_cast<float>(12 - i);
+            trail.Push({ 200 + static_cast<int>(d * std::cos(ang)), 200 + static_cast<int>(d * std::sin(ang)) },
+                now - std::chrono::milliseconds(4 * i));
+        }
+
+        TrailRenderer renderer;
+        for (RenderMethod m : { RenderMethod::Stamp, RenderMethod::Swept })
+        {
+            settings.method = m;
+            TrailRenderStats stats;
+            const double ns = MeasureNsPerCall([&]
+            {
+                stats = renderer.Render(dst.View(), sprite, trail, 0, 0, now, settings);
+                ClearRect(dst.View(), stats.bounds);
+            });
+            std::printf("%-8s %5.0f %-6s %10d %14llu %12.1f\n", c.name, c.degrees, m == RenderMethod::Stamp ? "stamp" : "swept",
+                stats.stamps, static_cast<unsigned long long>(stats.pixelsBlended), ns / 1e3);
+        }
+    }
+    return 0;
+}
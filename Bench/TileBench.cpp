@@ -0,0 +1,103 @@
+#include "Bench/BenchUtil.h"
+#include "Core/SyntheticTrace.h"
+#include "Core/TrailRenderer.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+// Scaling of the tile-parallel stamping compositor with 1, 2, 4 and 8 threads over a heavy
+// trail: a 96px accessibility cursor in fast circles across a 4K surface with a 400ms fade,
+// replayed frame by frame at 240 Hz on a simulated clock. One thread is the plain serial
+// RenderTrail. Every run's frames are checksummed against it.
+struct TileRun final
+{
+    double meanUs = 0, p99Us = 0;
+    uint64_t stamps = 0, pixelsBlended = 0, steals = 0, checksum = 0;
+    int frames = 0;
+};
+
+static TileRun Replay(const std::vector<TraceSample>& trace, const Sprite& sprite, const TrailSettings& settings,
+    int threads)
+{
+    TileRun r;
+    PixelBuffer dst;
+    dst.Resize(3840, 2160);
+    TrailBuffer trail(kMaxTrailSize);
+    TrailRenderer renderer;
+    WorkStealingPool pool(threads);
+    if (threads > 1)
+        renderer.SetPool(&pool);
+
+    const int64_t frameUs = 1000000 / 240;
+    const auto epoch = TrailClock::time_point{} + std::chrono::seconds(1);
+    std::vector<double> frameNs;
+    TrailRenderStats last;
+    size_t next = 0;
+    for (int64_t us = 0; us <= trace.back().us; us += frameUs)
+    {
+        const auto now = epoch + std::chrono::microseconds(us);
+        for (; next < trace.size() && trace[next].us <= us; ++next)
+            UpdateTrail(trail, trace[next].pt, epoch + std::chrono::microseconds(trace[next].us), settings);
+        ExpireTrail(trail, now, settings);
+
+        ClearRect(dst.View(), last.bounds);
+        const auto start = BenchClock::now();
+        last = renderer.Render(dst.View(), sprite, trail, 0, 0, now, settings);
+        frameNs.push_back(std::chrono::duration<double, std::nano>(BenchClock::now() - start).count());
+        r.stamps += last.stamps;
+        r.pixelsBlended += last.pixelsBlended;
+
+        // FNV-1a over the stamped area
+        for (int y = last.bounds.top; y < last.bounds.bottom; y += 7)
+        {
+            for (int x = last.bounds.left; x < last.bounds.right; ++x)
+                r.checksum = (r.checksum ^ dst.View().Row(y)[x]) * 1099511628211ull;
+        }
+    }
+
+    r.frames = static_cast<int>(frameNs.size());
+    for (double ns : frameNs)
+        r.meanUs += ns / 1e3;
+    r.meanUs /= static_cast<double>(r.frames);
+    const size_t p99 = std::min(frameNs.size() - 1, frameNs.size() * 99 / 100);
+    std::nth_element(frameNs.begin(), frameNs.begin() + p99, frameNs.end());
+    r.p99Us = frameNs[p99] / 1e3;
+    r.steals = pool.Steals();
+    return r;
+}
+
+int main()
+{
+    Sprite sprite;
+    sprite.w = sprite.h = 96;
+    sprite.hotX = sprite.hotY = 8;
+    sprite.px.resize(static_cast<size_t>(sprite.w) * sprite.h);
+    for (int y = 0; y < sprite.h; ++y)
+    {
+        for (int x = 0; x < sprite.w; ++x)
+        {
+            const uint32_t a = (x + y < 120) ? 255u : 0u;
+            sprite.px[static_cast<size_t>(y) * sprite.w + x] = (a << 24) | (a << 16) | (a << 8) | a;
+        }
+    }
+
+    TrailSettings settings;
+    settings.maxAlpha = 255;
+    settings.fadeMs = 400.f;
+    const std::vector<TraceSample> trace = MakeSyntheticTrace(TracePattern::Circles, 3840, 2160, 2000);
+
+    std::printf("%-8s %10s %10s %9s %12s %16s %8s %6s\n", "threads", "mean us", "p99 us", "speedup",
+        "stamps/f", "px blended/f", "steals", "match");
+    TileRun serial;
+    for (const int threads : { 1, 2, 4, 8 })
+    {
+        const TileRun r = Replay(trace, sprite, settings, threads);
+        if (threads == 1)
+            serial = r;
+        std::printf("%-8d %10.1f %10.1f %8.2fx %12llu %16llu %8llu %6s\n", threads, r.meanUs, r.p99Us,
+            serial.meanUs / r.meanUs, static_cast<unsigned long long>(r.stamps / r.frames),
+            static_cast<unsigned long long>(r.pixelsBlended / r.frames), static_cast<unsigned long long>(r.steals),
+            r.checksum == serial.checksum ? "yes" : "NO");
+    }
+    return 0;
+}
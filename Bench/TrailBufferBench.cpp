@@ -0,0 +1,97 @@
+#include "Bench/BenchUtil.h"
+#include "Core/TrailBuffer.h"
+#include <cstdio>
+#include <deque>
+
+// Reference: the original std::deque trail with interleaved POINT/time_point samples
+struct DequeSample final
+{
+    TrailPoint pt;
+    TrailClock::time_point t;
+};
+
+struct DequeTrail final
+{
+    std::deque<DequeSample> q;
+    size_t maxSize;
+
+    void Push(TrailPoint pt, TrailClock::time_point t)
+    {
+        q.push_back({ pt, t });
+        if (q.size() > maxSize)
+            q.pop_front();
+    }
+
+    void Expire(TrailClock::time_point now, float maxAgeMs)
+    {
+        while (!q.empty() &&
+            std::chrono::duration_cast<std::chrono::milliseconds>(now - q.front().t).count() > maxAgeMs)
+            q.pop_front();
+    }
+
+    int64_t Iterate(TrailClock::time_point now) const
+    {
+        int64_t acc = 0;
+        for (const DequeSample& s : q)
+            acc += s.pt.x + std::chrono::duration_cast<std::chrono::milliseconds>(now - s.t).count();
+        return acc;
+    }
+};
+
+static int64_t IterateRing(const TrailBuffer& buf, TrailClock::time_point now)
+{
+    const int32_t nowUs = buf.ToUs(now);
+    TrailBuffer::Run runs[2];
+    const size_t n = buf.Runs(runs);
+    int64_t acc = 0;
+    for (size_t r = 0; r < n; ++r)
+    {
+        for (size_t i = 0; i < runs[r].count; ++i)
+            acc += runs[r].x[i] + (nowUs - runs[r].t[i]) / 1000;
+    }
+    return acc;
+}
+
+// Steady state: one push, one expire and one full iteration per simulated frame,
+// with the fade window sized so the trail holds about `samples` entries
+static void RunCase(size_t samples)
+{
+    const auto step = std::chrono::microseconds(250);
+    const float maxAgeMs = static_cast<float>(samples) * 0.25f;
+
+    DequeTrail dq{ {}, samples };
+    TrailBuffer ring(samples);
+    auto tDq = TrailClock::time_point{} + std::chrono::seconds(1);
+    auto tRing = tDq;
+    int xDq = 0, xRing = 0;
+
+    const double dqPush = MeasureNsPerCall([&] { dq.Push({ ++xDq, 0 }, tDq += step); }, 100.0);
+    const double ringPush = MeasureNsPerCall([&] { ring.Push({ ++xRing, 0 }, tRing += step); }, 100.0);
+
+    const double dqExpire = MeasureNsPerCall([&]
+    {
+        dq.Push({ ++xDq, 0 }, tDq += step);
+        dq.Expire(tDq, maxAgeMs);
+    }, 100.0);
+    const double ringExpire = MeasureNsPerCall([&]
+    {
+        ring.Push({ ++xRing, 0 }, tRing += step);
+        ring.ExpireOlderThan(tRing, maxAgeMs);
+    }, 100.0);
+
+    int64_t sink = 0;
+    const double dqIter = MeasureNsPerCall([&] { sink += dq.Iterate(tDq); }, 100.0);
+    const double ringIter = MeasureNsPerCall([&] { sink += IterateRing(ring, tRing); }, 100.0);
+    DoNotOptimize(sink);
+
+    std::printf("%6zu %-6s %12.1f %16.1f %14.1f\n", samples, "deque", dqPush, dqExpire, dqIter);
+    std::printf("%6zu %-6s %12.1f %16.1f %14.1f\n", samples, "ring", ringPush, ringExpire, ringIter);
+}
+
+int main()
+{
+    std::printf("%6s %-6s %12s %16s %14s\n", "size", "impl", "push ns", "push+expire ns", "iterate ns");
+    RunCase(500);
+    RunCase(5000);
+    return 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+// Allocator returning Align-byte aligned storage, so SIMD loops over the data start on a
+// cache line. Not final: std::vector implementations derive from their allocator.
+template<typename T, size_t Align>
+struct AlignedAllocator
+{
+    using value_type = T;
+
+    template<typename U>
+    struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() noexcept = default;
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {}
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+
+    void deallocate(T* p, size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Align>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U, Align>&) const noexcept { return false; }
+};
+
+constexpr size_t kPixelAlign = 64;
+using PixelVector = std::vector<uint32_t, AlignedAllocator<uint32_t, kPixelAlign>>;
@@ -0,0 +1,139 @@
+#include "Core/Blend.h"
+#include <algorithm>
+
+#if defined(CURSORBLUR_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+void BlendRowScalar(uint32_t* dst, const uint32_t* src, int count, uint32_t alpha) noexcept
+{
+    for (int i = 0; i < count; ++i)
+    {
+        const uint32_t sc = src[i];
+        const uint32_t dc = dst[i];
+        const uint32_t inv = 255 - Div255((sc >> 24) * alpha);
+
+        uint32_t out = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            const uint32_t v = Div255(((sc >> shift) & 0xFF) * alpha) + Div255(((dc >> shift) & 0xFF) * inv);
+            out |= std::min(v, 255u) << shift;
+        }
+        dst[i] = out;
+    }
+}
+
+#if defined(CURSORBLUR_X86)
+static bool CpuHasSSE2() noexcept
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return true; // Baseline on x64
+#elif defined(_MSC_VER)
+    int info[4]{};
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static bool CpuHasAVX2() noexcept
+{
+#if defined(_MSC_VER)
+    int info[4]{};
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    // AVX2 also needs the OS to save YMM state
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+const char* BlendKernelName(BlendKernel kernel) noexcept
+{
+    switch (kernel)
+    {
+        case BlendKernel::Scalar: return "scalar";
+        case BlendKernel::SSE2: return "sse2";
+        case BlendKernel::AVX2: return "avx2";
+        case BlendKernel::NEON: return "neon";
+        default: return "unknown";
+    }
+}
+
+BlendRowFn GetBlendRow(BlendKernel kernel) noexcept
+{
+    switch (kernel)
+    {
+        case BlendKernel::Scalar:
+            return BlendRowScalar;
+#if defined(CURSORBLUR_X86)
+        case BlendKernel::SSE2:
+            return CpuHasSSE2() ? BlendRowSSE2 : nullptr;
+        case BlendKernel::AVX2:
+            return CpuHasAVX2() ? BlendRowAVX2 : nullptr;
+#endif
+#if defined(CURSORBLUR_NEON)
+        case BlendKernel::NEON:
+            return BlendRowNEON;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+BlendKernel BestBlendKernel() noexcept
+{
+    for (BlendKernel k : { BlendKernel::AVX2, BlendKernel::NEON, BlendKernel::SSE2 })
+    {
+        if (GetBlendRow(k))
+            return k;
+    }
+    return BlendKernel::Scalar;
+}
+
+// Selected on first use rather than during static init, so CPU detection is ready
+struct ActiveKernel final
+{
+    BlendKernel kind = BestBlendKernel();
+    BlendRowFn fn = GetBlendRow(kind);
+};
+
+static ActiveKernel& Active() noexcept
+{
+    static ActiveKernel active;
+    return active;
+}
+
+bool SetActiveBlendKernel(BlendKernel kernel) noexcept
+{
+    BlendRowFn fn = GetBlendRow(kernel);
+    if (!fn)
+        return false;
+
+    Active() = { kernel, fn };
+    return true;
+}
+
+BlendKernel ActiveBlendKernel() noexcept
+{
+    return Active().kind;
+}
+
+BlendRowFn ActiveBlendRow() noexcept
+{
+    return Active().fn;
+}
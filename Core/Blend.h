@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+
+// Premultiplied BGRA source-over for one row of pixels:
+//   dst = src * alpha + dst * (1 - srcA * alpha)
+// with every product rounded to /255, saturating per channel. Matches GDI
+// AlphaBlend with AC_SRC_OVER, AC_SRC_ALPHA and SourceConstantAlpha = alpha.
+using BlendRowFn = void (*)(uint32_t* dst, const uint32_t* src, int count, uint32_t alpha) noexcept;
+
+enum class BlendKernel
+{
+    Scalar,
+    SSE2,
+    AVX2,
+    NEON,
+    Count
+};
+
+// Display name of a kernel variant
+const char* BlendKernelName(BlendKernel kernel) noexcept;
+
+// Row function for the variant, or nullptr if it was not compiled in or the CPU lacks support
+BlendRowFn GetBlendRow(BlendKernel kernel) noexcept;
+
+// Fastest variant supported by the running CPU
+BlendKernel BestBlendKernel() noexcept;
+
+// Variant used by BlendSprite; defaults to BestBlendKernel(). Returns false if unsupported.
+bool SetActiveBlendKernel(BlendKernel kernel) noexcept;
+BlendKernel ActiveBlendKernel() noexcept;
+BlendRowFn ActiveBlendRow() noexcept;
+
+// Scalar reference, always available
+void BlendRowScalar(uint32_t* dst, const uint32_t* src, int count, uint32_t alpha) noexcept;
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CURSORBLUR_X86 1
+void BlendRowSSE2(uint32_t* dst, const uint32_t* src, int count, uint32_t alpha) noexcept;
+void BlendRowAVX2(uint32_t* dst, const uint32_t* src, int count, uint32_t alpha) noexcept;
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define CURSORBLUR_NEON 1
+void BlendRowNEON(uint32_t* dst, const uint32_t* src, int count, uint32_t alpha) noexcept;
+#endif
+
+// Rounded x / 255 for x in [0, 255 * 255]
+inline uint32_t Div255(uint32_t x) noexcept
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
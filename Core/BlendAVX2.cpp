@@ -0,0 +1,51 @@
+#include "Core/Blend.h"
+
+// Compiled with AVX2 code generation enabled; only called after a CPUID check
+#if defined(CURSORBLUR_X86)
+#include <immintrin.h>
+
+// Rounded x / 255 on 16-bit lanes holding x in [0, 255 * 255]
+static inline __m256i Div255Epu16(__m256i x) noexcept
+{
+    x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+// Copies each pixel's alpha lane into all four of its 16-bit lanes
+static inline __m256i BroadcastAlphaEpu16(__m256i v) noexcept
+{
+    v = _mm256_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3));
+    return _mm256_shufflehi_epi16(v, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+// Blends four unpacked pixels (16 x u16)
+static inline __m256i BlendQuad(__m256i s, __m256i d, __m256i a, __m256i c255) noexcept
+{
+    const __m256i sp = Div255Epu16(_mm256_mullo_epi16(s, a));
+    const __m256i inv = _mm256_sub_epi16(c255, BroadcastAlphaEpu16(sp));
+    const __m256i dp = Div255Epu16(_mm256_mullo_epi16(d, inv));
+    return _mm256_add_epi16(sp, dp);
+}
+
+void BlendRowAVX2(uint32_t* dst, const uint32_t* src, int count, uint32_t alpha) noexcept
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i c255 = _mm256_set1_epi16(255);
+    const __m256i a = _mm256_set1_epi16(static_cast<short>(alpha));
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+
+        // Unpack and pack both work per 128-bit lane, so pixel order is preserved
+        const __m256i lo = BlendQuad(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), a, c255);
+        const __m256i hi = BlendQuad(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), a, c255);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+
+    if (i < count)
+        BlendRowSSE2(dst + i, src + i, count - i, alpha);
+}
+#endif
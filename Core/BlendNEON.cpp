@@ -0,0 +1,40 @@
+#include "Core/Blend.h"
+
+#if defined(CURSORBLUR_NEON)
+#include <arm_neon.h>
+
+// Rounded x / 255 on 16-bit lanes holding x in [0, 255 * 255], narrowed to bytes
+static inline uint8x8_t Div255Narrow(uint16x8_t x) noexcept
+{
+    x = vaddq_u16(x, vdupq_n_u16(128));
+    return vshrn_n_u16(vsraq_n_u16(x, x, 8), 8);
+}
+
+void BlendRowNEON(uint32_t* dst, const uint32_t* src, int count, uint32_t alpha) noexcept
+{
+    static const uint8_t kAlphaIdx[16] = { 3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15 };
+    const uint8x16_t alphaIdx = vld1q_u8(kAlphaIdx);
+    const uint8x8_t a = vdup_n_u8(static_cast<uint8_t>(alpha));
+    const uint8x16_t c255 = vdupq_n_u8(255);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const uint8x16_t s = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+        const uint8x16_t d = vld1q_u8(reinterpret_cast<const uint8_t*>(dst + i));
+
+        const uint8x16_t sp = vcombine_u8(
+            Div255Narrow(vmull_u8(vget_low_u8(s), a)),
+            Div255Narrow(vmull_u8(vget_high_u8(s), a)));
+        const uint8x16_t inv = vsubq_u8(c255, vqtbl1q_u8(sp, alphaIdx));
+        const uint8x16_t dp = vcombine_u8(
+            Div255Narrow(vmull_u8(vget_low_u8(d), vget_low_u8(inv))),
+            Div255Narrow(vmull_u8(vget_high_u8(d), vget_high_u8(inv))));
+
+        vst1q_u8(reinterpret_cast<uint8_t*>(dst + i), vqaddq_u8(sp, dp));
+    }
+
+    if (i < count)
+        BlendRowScalar(dst + i, src + i, count - i, alpha);
+}
+#endif
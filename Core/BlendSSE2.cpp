@@ -0,0 +1,49 @@
+#include "Core/Blend.h"
+
+#if defined(CURSORBLUR_X86)
+#include <emmintrin.h>
+
+// Rounded x / 255 on 16-bit lanes holding x in [0, 255 * 255]
+static inline __m128i Div255Epu16(__m128i x) noexcept
+{
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// Copies each pixel's alpha lane (3 and 7) into all four of its 16-bit lanes
+static inline __m128i BroadcastAlphaEpu16(__m128i v) noexcept
+{
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3));
+    return _mm_shufflehi_epi16(v, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+// Blends two unpacked pixels (8 x u16)
+static inline __m128i BlendPair(__m128i s, __m128i d, __m128i a, __m128i c255) noexcept
+{
+    const __m128i sp = Div255Epu16(_mm_mullo_epi16(s, a));
+    const __m128i inv = _mm_sub_epi16(c255, BroadcastAlphaEpu16(sp));
+    const __m128i dp = Div255Epu16(_mm_mullo_epi16(d, inv));
+    return _mm_add_epi16(sp, dp);
+}
+
+void BlendRowSSE2(uint32_t* dst, const uint32_t* src, int count, uint32_t alpha) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i a = _mm_set1_epi16(static_cast<short>(alpha));
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+
+        const __m128i lo = BlendPair(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), a, c255);
+        const __m128i hi = BlendPair(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), a, c255);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    }
+
+    if (i < count)
+        BlendRowScalar(dst + i, src + i, count - i, alpha);
+}
+#endif
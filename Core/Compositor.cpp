@@ -0,0 +1,441 @@
+#include "Core/Compositor.h"
+#include "Core/Blend.h"
+#include "Core/TrailStepper.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CURSORBLUR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+void ClearSurface(const SurfaceView& s) noexcept
+{
+    if (s.Empty())
+        return;
+
+    if (s.stride == s.w)
+    {
+        std::memset(s.bits, 0, static_cast<size_t>(s.w) * s.h * sizeof(uint32_t));
+        return;
+    }
+
+    for (int y = 0; y < s.h; ++y)
+        std::memset(s.Row(y), 0, static_cast<size_t>(s.w) * sizeof(uint32_t));
+}
+
+void ClearRect(const SurfaceView& s, const PixelRect& r) noexcept
+{
+    const PixelRect c = RectIntersect(r, { 0, 0, s.w, s.h });
+    if (s.Empty() || c.Empty())
+        return;
+
+    for (int y = c.top; y < c.bottom; ++y)
+        std::memset(s.Row(y) + c.left, 0, static_cast<size_t>(c.Width()) * sizeof(uint32_t));
+}
+
+// 16x16 ordered-dither matrix holding each of 0..255 once, rows stored twice over
+// so a window of 16 starting anywhere in the first half is contiguous
+struct DitherMatrix final
+{
+    uint16_t v[16][32 * 4]; // Per pixel, replicated for the 4 channels
+
+    DitherMatrix() noexcept
+    {
+        for (int y = 0; y < 16; ++y)
+        {
+            for (int x = 0; x < 32; ++x)
+            {
+                // Bayer recursion: each 2x2 level contributes 0, 2, 3, 1, the finest level most significant
+                uint32_t m = 0;
+                for (int bit = 0; bit < 4; ++bit)
+                {
+                    const uint32_t bx = (x >> bit) & 1, by = (y >> bit) & 1;
+                    m = (m << 2) | ((bx ^ by) << 1) | by;
+                }
+                for (int c = 0; c < 4; ++c)
+                    v[y][x * 4 + c] = static_cast<uint16_t>(m);
+            }
+        }
+    }
+};
+
+static const DitherMatrix sDither;
+
+bool DecayRect(const SurfaceView& s, const PixelRect& r, uint32_t keep, uint32_t seed) noexcept
+{
+    const PixelRect c = RectIntersect(r, { 0, 0, s.w, s.h });
+    if (s.Empty() || c.Empty())
+        return false;
+
+    // The per-call seed moves the dither pattern so rounding errors do not line up over frames
+    const int shiftX = static_cast<int>(seed & 15);
+    const int shiftY = static_cast<int>((seed >> 4) & 15);
+    keep = std::min<uint32_t>(keep, 0xFFFF);
+
+    // Per channel: t = (c * 256 * keep) >> 16, then (t + dither) >> 8, so the mean result is c * keep / 65536
+    uint32_t live = 0;
+#if defined(CURSORBLUR_SSE2)
+    const __m128i keepV = _mm_set1_epi16(static_cast<short>(keep));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi32(2);
+    __m128i liveV = zero;
+#endif
+    for (int y = c.top; y < c.bottom; ++y)
+    {
+        uint32_t* row = s.Row(y);
+        const uint16_t* dither = sDither.v[(y + shiftY) & 15];
+        int x = c.left;
+#if defined(CURSORBLUR_SSE2)
+        for (; x + 4 <= c.right; x += 4)
+        {
+            const int dx = (x + shiftX) & 15;
+            const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+            const __m128i lo = _mm_mulhi_epu16(_mm_slli_epi16(_mm_unpacklo_epi8(px, zero), 8), keepV);
+            const __m128i hi = _mm_mulhi_epu16(_mm_slli_epi16(_mm_unpackhi_epi8(px, zero), 8), keepV);
+            const __m128i dLo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither + dx * 4));
+            const __m128i dHi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither + dx * 4 + 8));
+            __m128i out = _mm_packus_epi16(_mm_srli_epi16(_mm_adds_epu16(lo, dLo), 8), _mm_srli_epi16(_mm_adds_epu16(hi, dHi), 8));
+
+            // Clear pixels whose alpha fell below 2
+            const __m128i faint = _mm_cmplt_epi32(_mm_srli_epi32(out, 24), two);
+            out = _mm_andnot_si128(faint, out);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), out);
+            liveV = _mm_or_si128(liveV, out);
+        }
+#endif
+        for (; x < c.right; ++x)
+        {
+            const uint32_t p = row[x];
+            if (!p)
+                continue;
+
+            const uint32_t d = dither[((x + shiftX) & 15) * 4];
+            const uint32_t a = ((((p >> 24) << 8) * keep >> 16) + d) >> 8;
+            if (a < 2)
+            {
+                row[x] = 0;
+                continue;
+            }
+
+            const uint32_t cr = (((((p >> 16) & 0xFF) << 8) * keep >> 16) + d) >> 8;
+            const uint32_t cg = (((((p >> 8) & 0xFF) << 8) * keep >> 16) + d) >> 8;
+            const uint32_t cb = ((((p & 0xFF) << 8) * keep >> 16) + d) >> 8;
+            row[x] = (a << 24) | (cr << 16) | (cg << 8) | cb;
+            live = 1;
+        }
+    }
+#if defined(CURSORBLUR_SSE2)
+    live |= static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(liveV, zero)) != 0xFFFF);
+#endif
+    return live != 0;
+}
+
+void TintPixels(uint32_t* px, size_t count, uint8_t r, uint8_t g, uint8_t b) noexcept
+{
+    size_t i = 0;
+#if CURSORBLUR_SSE2
+    // Four pixels per iteration in 16-bit lanes; alpha is scaled by 255 / 255.
+    // x / 255 truncated equals (x * 0x8081) >> 23 for every product x <= 255 * 255.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i tint = _mm_setr_epi16(b, g, r, 255, b, g, r, 255);
+    const __m128i magic = _mm_set1_epi16(static_cast<short>(0x8081));
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(px + i));
+        __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(c, zero), tint);
+        __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(c, zero), tint);
+        lo = _mm_srli_epi16(_mm_mulhi_epu16(lo, magic), 7);
+        hi = _mm_srli_epi16(_mm_mulhi_epu16(hi, magic), 7);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(px + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        const uint32_t c = px[i];
+        const uint32_t cb = ((c & 0xFF) * b) / 255;
+        const uint32_t cg = (((c >> 8) & 0xFF) * g) / 255;
+        const uint32_t cr = (((c >> 16) & 0xFF) * r) / 255;
+        px[i] = (c & 0xFF000000u) | (cr << 16) | (cg << 8) | cb;
+    }
+}
+
+PixelRect SpriteRect(const SurfaceView& dst, const Sprite& sprite, int dstX, int dstY) noexcept
+{
+    return RectIntersect({ dstX, dstY, dstX + sprite.w, dstY + sprite.h }, { 0, 0, dst.w, dst.h });
+}
+
+PixelRect TrailBounds(const TrailBuffer& trail, const Sprite& sprite) noexcept
+{
+    if (trail.Empty() || sprite.Empty())
+        return {};
+
+    const TrailPoint first = trail.Point(0);
+    PixelRect r{ first.x, first.y, first.x, first.y };
+
+    TrailBuffer::Run runs[2];
+    const size_t nRuns = trail.Runs(runs);
+    for (size_t k = 0; k < nRuns; ++k)
+    {
+        const TrailBuffer::Run& run = runs[k];
+        for (size_t i = 0; i < run.count; ++i)
+        {
+            r.left = std::min(r.left, run.x[i]);
+            r.top = std::min(r.top, run.y[i]);
+            r.right = std::max(r.right, run.x[i]);
+            r.bottom = std::max(r.bottom, run.y[i]);
+        }
+    }
+
+    // Stamps are placed at round(position) - hotspot
+    return { r.left - sprite.hotX, r.top - sprite.hotY,
+        r.right - sprite.hotX + sprite.w, r.bottom - sprite.hotY + sprite.h };
+}
+
+uint64_t BlendSprite(const SurfaceView& dst, const Sprite& sprite, int dstX, int dstY, uint8_t alpha, int frame) noexcept
+{
+    if (dst.Empty() || sprite.Empty() || alpha == 0)
+        return 0;
+
+    // Clip sprite rectangle against destination
+    const PixelRect r = SpriteRect(dst, sprite, dstX, dstY);
+    if (r.Empty())
+        return 0;
+
+    const BlendRowFn blendRow = ActiveBlendRow();
+    for (int y = r.top; y < r.bottom; ++y)
+    {
+        const uint32_t* s = sprite.FramePixels(frame) + static_cast<size_t>(y - dstY) * sprite.w + (r.left - dstX);
+        blendRow(dst.Row(y) + r.left, s, r.Width(), alpha);
+    }
+
+    return r.Area();
+}
+
+void BuildPhaseSprites(const Sprite& src, std::vector<Sprite>& out)
+{
+    constexpr int g = kSubpixelGrid;
+    out.assign(static_cast<size_t>(g) * g, Sprite{});
+    if (src.Empty())
+        return;
+
+    const int w = src.w + 1, h = src.h + 1;
+    for (int fy = 0; fy < g; ++fy)
+    {
+        for (int fx = 0; fx < g; ++fx)
+        {
+            Sprite& dst = out[static_cast<size_t>(fy) * g + fx];
+            dst.w = w;
+            dst.h = h;
+            dst.hotX = src.hotX;
+            dst.hotY = src.hotY;
+            dst.frames = src.frames;
+            dst.frameEndUs = src.frameEndUs;
+            dst.px.resize(static_cast<size_t>(w) * h * src.frames);
+
+            // Weights of the four source pixels under each destination pixel, in 1 / g^2
+            const uint32_t w00 = (g - fx) * (g - fy), w10 = fx * (g - fy), w01 = (g - fx) * fy, w11 = fx * fy;
+            for (int f = 0; f < src.frames; ++f)
+            {
+                const uint32_t* s = src.FramePixels(f);
+                uint32_t* d = dst.px.data() + static_cast<size_t>(f) * w * h;
+                const auto at = [&](int x, int y) -> uint32_t
+                {
+                    return x >= 0 && y >= 0 && x < src.w && y < src.h ? s[static_cast<size_t>(y) * src.w + x] : 0u;
+                };
+                for (int y = 0; y < h; ++y)
+                {
+                    for (int x = 0; x < w; ++x)
+                    {
+                        const uint32_t p00 = at(x, y), p10 = at(x - 1, y), p01 = at(x, y - 1), p11 = at(x - 1, y - 1);
+                        uint32_t v = 0;
+                        for (int c = 0; c < 32; c += 8)
+                        {
+                            const uint32_t sum = w00 * ((p00 >> c) & 0xFF) + w10 * ((p10 >> c) & 0xFF) +
+                                w01 * ((p01 >> c) & 0xFF) + w11 * ((p11 >> c) & 0xFF);
+                            v |= ((sum + g * g / 2) / (g * g)) << c;
+                        }
+                        d[static_cast<size_t>(y) * w + x] = v;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Walks the stamps of the trail from oldest to newest, calling fn(x, y, alpha, frame)
+// with the screen position under the hotspot for every stamp visible enough to draw
+template <typename Fn>
+static void ForEachStamp(const Sprite& sprite, const TrailBuffer& trail, TrailClock::time_point now,
+    const TrailSettings& settings, const TrailAlphaLut& lut, Fn&& fn)
+{
+    const int32_t nowUs = trail.ToUs(now);
+    const bool animated = sprite.Animated() && !trail.Empty();
+    const int64_t epochUs = animated ? std::chrono::duration_cast<std::chrono::microseconds>(
+        trail.TimePoint(0).time_since_epoch()).count() - trail.TimeUs(0) : 0;
+    int64_t shortestFrameUs = 0;
+    for (int f = 0; animated && f < sprite.frames; ++f)
+    {
+        const int64_t len = sprite.frameEndUs[f] - (f ? sprite.frameEndUs[f - 1] : 0);
+        shortestFrameUs = f ? std::min(shortestFrameUs, len) : len;
+    }
+
+    const int maxStepPx = std::min(sprite.w, sprite.h) / kStampsPerCursor;
+
+    // Draw samples in order from oldest to newest
+    for (int i = static_cast<int>(trail.Size()) - 2; i >= 0; --i)
+    {
+        // Whole milliseconds, truncated like duration_cast
+        const int64_t age0 = (static_cast<int64_t>(nowUs) - trail.TimeUs(i)) / 1000;
+        if (static_cast<float>(age0) > settings.fadeMs)
+            continue;
+
+        // With an error budget, faint segments take fewer, wider steps
+        int steps = 0;
+        if (settings.errorBudget)
+            steps = AdaptiveSegmentSteps(trail.Point(i), trail.Point(i + 1), static_cast<int>(age0), lut, maxStepPx, settings.errorBudget);
+        else if (animated)
+            steps = SegmentSteps(trail.Point(i), trail.Point(i + 1));
+
+        // Animation frame per stamp. A segment shorter than any frame that starts and ends
+        // on the same one shows only that frame; others interpolate each stamp's time.
+        int frame = 0, j = steps;
+        bool perStamp = false;
+        int64_t t0 = 0, dt = 0;
+        if (animated)
+        {
+            t0 = epochUs + trail.TimeUs(i);
+            dt = static_cast<int64_t>(trail.TimeUs(i + 1)) - trail.TimeUs(i);
+            frame = sprite.FrameAt(t0);
+            perStamp = dt >= shortestFrameUs || sprite.FrameAt(t0 + dt) != frame;
+        }
+
+        // Interpolate between samples to fill gaps
+        const auto stamp = [&](int px, int py, uint8_t a)
+        {
+            const int k = j--;
+            if (a < 3)
+                return;
+
+            fn(px, py, a, perStamp ? sprite.FrameAt(t0 + dt * k / steps) : frame);
+        };
+        if (settings.errorBudget)
+            StepSegmentIn(trail.Point(i), trail.Point(i + 1), static_cast<int>(age0), lut, steps, stamp);
+        else
+            StepSegment(trail.Point(i), trail.Point(i + 1), static_cast<int>(age0), lut, stamp);
+    }
+}
+
+// Holds back each stamp until the next one shows whether it continues a run at the same
+// position and frame, folding a run into one stamp and dropping results below the cull alpha
+template <typename Fn>
+class StampCoalescer final
+{
+public:
+    StampCoalescer(uint8_t cullAlpha, Fn& fn) noexcept : cull_(cullAlpha), fn_(fn) {}
+
+    void Add(int x, int y, uint8_t a, int f)
+    {
+        if (pending_ && x == x_ && y == y_ && f == f_)
+        {
+            keep_ = keep_ * static_cast<float>(255 - a) * (1.f / 255.f);
+            ++removed_;
+            return;
+        }
+        Flush();
+        pending_ = true;
+        x_ = x;
+        y_ = y;
+        f_ = f;
+        keep_ = static_cast<float>(255 - a);
+    }
+
+    void Flush()
+    {
+        if (!pending_)
+            return;
+        pending_ = false;
+        const uint8_t a = static_cast<uint8_t>(255 - static_cast<int>(keep_ + 0.5f));
+        if (a < cull_)
+            ++removed_;
+        else
+            fn_(x_, y_, a, f_);
+    }
+
+    [[nodiscard]] int Removed() const noexcept { return removed_; }
+
+private:
+    uint8_t cull_;
+    Fn& fn_;
+    bool pending_ = false;
+    int x_ = 0, y_ = 0, f_ = 0;
+    float keep_ = 0.f; // 255 * (1 - combined alpha)
+    int removed_ = 0;
+};
+
+// ForEachStamp with coalescing and culling as settings ask; returns the stamps they removed
+template <typename Fn>
+static int ForEachBlend(const Sprite& sprite, const TrailBuffer& trail, TrailClock::time_point now,
+    const TrailSettings& settings, const TrailAlphaLut& lut, Fn&& fn)
+{
+    if (!settings.coalesce && settings.cullAlpha <= 3)
+    {
+        ForEachStamp(sprite, trail, now, settings, lut, fn);
+        return 0;
+    }
+
+    StampCoalescer<Fn> merger(settings.cullAlpha, fn);
+    if (settings.coalesce)
+        ForEachStamp(sprite, trail, now, settings, lut, [&](int px, int py, uint8_t a, int f) { merger.Add(px, py, a, f); });
+    else
+        ForEachStamp(sprite, trail, now, settings, lut, [&](int px, int py, uint8_t a, int f) { merger.Add(px, py, a, f); merger.Flush(); });
+    merger.Flush();
+    return merger.Removed();
+}
+
+TrailRenderStats RenderTrail(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+    int originX, int originY, TrailClock::time_point now, const TrailSettings& settings,
+    const TrailAlphaLut& lut) noexcept
+{
+    TrailRenderStats stats;
+    if (dst.Empty() || sprite.Empty())
+        return stats;
+
+    stats.stampsCoalesced = ForEachBlend(sprite, trail, now, settings, lut, [&](int px, int py, uint8_t a, int f)
+    {
+        const int dstX = px - originX - sprite.hotX;
+        const int dstY = py - originY - sprite.hotY;
+        const uint64_t blended = BlendSprite(dst, sprite, dstX, dstY, a, f);
+        if (blended)
+            stats.bounds = RectUnion(stats.bounds, SpriteRect(dst, sprite, dstX, dstY));
+        stats.pixelsBlended += blended;
+        ++stats.stamps;
+    });
+
+    return stats;
+}
+
+size_t CollectStamps(const Sprite& sprite, const TrailBuffer& trail, TrailClock::time_point now,
+    const TrailSettings& settings, const TrailAlphaLut& lut, std::vector<SpriteStamp>& out, int* coalesced)
+{
+    out.clear();
+    if (sprite.Empty())
+        return 0;
+
+    const int removed = ForEachBlend(sprite, trail, now, settings, lut, [&](int px, int py, uint8_t a, int f)
+    {
+        out.push_back({ px - sprite.hotX, py - sprite.hotY, a, f });
+    });
+    if (coalesced)
+        *coalesced = removed;
+    return out.size();
+}
+
+TrailRenderStats RenderTrail(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+    int originX, int originY, TrailClock::time_point now, const TrailSettings& settings)
+{
+    static thread_local TrailAlphaLut lut;
+    lut.Update(settings);
+    return RenderTrail(dst, sprite, trail, originX, originY, now, settings, lut);
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include "Core/AlignedVector.h"
+#include "Core/Surface.h"
+#include "Core/Trail.h"
+#include "Core/Damage.h"
+
+// Tinted cursor image, premultiplied BGRA as produced by DrawIconEx onto black.
+// Animated cursors keep every frame in one atlas, frames stacked top to bottom.
+struct Sprite final
+{
+    PixelVector px;
+    int w = 0, h = 0, hotX = 0, hotY = 0;
+    int frames = 1;
+    std::vector<int64_t> frameEndUs; // Animated only: cumulative end of each frame within one cycle
+
+    [[nodiscard]] bool Empty() const noexcept { return px.empty() || w <= 0 || h <= 0; }
+    [[nodiscard]] bool Animated() const noexcept { return frames > 1 && frameEndUs.size() == static_cast<size_t>(frames); }
+
+    [[nodiscard]] const uint32_t* FramePixels(int frame) const noexcept
+    {
+        return px.data() + static_cast<size_t>(frame) * w * h;
+    }
+
+    // Frame showing at us microseconds on TrailClock, the animation cycling from the clock's epoch
+    [[nodiscard]] int FrameAt(int64_t us) const noexcept
+    {
+        if (!Animated() || frameEndUs.back() <= 0)
+            return 0;
+        int64_t t = us % frameEndUs.back();
+        if (t < 0)
+            t += frameEndUs.back();
+        int f = 0;
+        while (f < frames - 1 && t >= frameEndUs[f])
+            ++f;
+        return f;
+    }
+};
+
+// Counters for a single rendered frame
+struct TrailRenderStats final
+{
+    int stamps = 0;             // Sprite stamps blended (or integrated, for the swept method)
+    uint64_t pixelsBlended = 0; // Destination pixels touched by those blends
+    PixelRect bounds;           // Union of stamped sprite rectangles, clipped to the surface
+    uint64_t pixelsDecayed = 0; // Pixels faded in place (accumulation mode only)
+    int stampsCoalesced = 0;    // Stamps merged into a neighbour or culled; stepped = stamps + this
+};
+
+// Multiplies the color channels of each pixel by the tint color (c * t / 255, truncated)
+void TintPixels(uint32_t* px, size_t count, uint8_t r, uint8_t g, uint8_t b) noexcept;
+
+// Destination rectangle covered by the sprite at (dstX, dstY), clipped to the surface
+[[nodiscard]] PixelRect SpriteRect(const SurfaceView& dst, const Sprite& sprite, int dstX, int dstY) noexcept;
+
+// Screen-space rectangle that can be touched when rendering the trail: every
+// sample position expanded by the sprite extent around its hotspot
+[[nodiscard]] PixelRect TrailBounds(const TrailBuffer& trail, const Sprite& sprite) noexcept;
+
+// Premultiplied source-over of one sprite frame at (dstX, dstY) scaled by a constant alpha,
+// equivalent to GDI AlphaBlend with AC_SRC_OVER and AC_SRC_ALPHA. Returns blended pixel count.
+uint64_t BlendSprite(const SurfaceView& dst, const Sprite& sprite, int dstX, int dstY, uint8_t alpha, int frame = 0) noexcept;
+
+// Replaces out with kSubpixelGrid^2 copies of src shifted right and down by (fx, fy) /
+// kSubpixelGrid px, bilinearly resampled, at index fx + fy * kSubpixelGrid. Each copy is one
+// pixel wider and taller than src with the same hotspot; animated sprites shift every frame.
+// Channels stay premultiplied, and the unshifted copy is src with a clear last row and column.
+void BuildPhaseSprites(const Sprite& src, std::vector<Sprite>& out);
+
+// Scales every channel of the premultiplied pixels in r by keep / 65536, with dithered
+// rounding so faint pixels fade on average at the same rate as bright ones. Pixels whose
+// alpha drops below 2 are cleared. Returns true if anything in r is still visible.
+bool DecayRect(const SurfaceView& s, const PixelRect& r, uint32_t keep, uint32_t seed) noexcept;
+
+class TrailAlphaLut;
+
+// Draws the trail from oldest to newest sample into dst. originX/originY is the
+// screen position of dst's top-left pixel. lut must be up to date with settings.
+// Animated sprites pick each stamp's frame from its time interpolated between samples.
+// With coalesce set, consecutive stamps of the same frame at the same position blend once
+// with the combined alpha 1 - (1 - a1)(1 - a2)..., which is exact for opaque and clear
+// sprite pixels and close for the translucent edge. With an error budget, segments whose
+// stamps are fainter than the budget are stepped more coarsely (see AdaptiveSegmentSteps).
+TrailRenderStats RenderTrail(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+    int originX, int originY, TrailClock::time_point now, const TrailSettings& settings,
+    const TrailAlphaLut& lut) noexcept;
+
+// Same, with an alpha table cached per thread
+TrailRenderStats RenderTrail(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+    int originX, int originY, TrailClock::time_point now, const TrailSettings& settings);
+
+// One sprite placement of a trail frame: top-left corner in screen pixels, opacity and animation frame
+struct SpriteStamp final
+{
+    int x = 0, y = 0;
+    uint8_t alpha = 0;
+    int frame = 0;
+
+    [[nodiscard]] bool operator==(const SpriteStamp& o) const noexcept
+    {
+        return x == o.x && y == o.y && alpha == o.alpha && frame == o.frame;
+    }
+    [[nodiscard]] bool operator!=(const SpriteStamp& o) const noexcept { return !(*this == o); }
+};
+
+// Replaces out with the stamps RenderTrail would blend, oldest first, without touching any
+// pixels. Blending them in order with BlendSprite reproduces RenderTrail. Returns the count;
+// coalesced, if given, receives the number of stamps coalescing removed.
+size_t CollectStamps(const Sprite& sprite, const TrailBuffer& trail, TrailClock::time_point now,
+    const TrailSettings& settings, const TrailAlphaLut& lut, std::vector<SpriteStamp>& out, int* coalesced = nullptr);
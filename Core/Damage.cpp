@@ -0,0 +1,23 @@
+#include "Core/Damage.h"
+
+FrameDamage DamageTracker::EndFrame(const PixelRect& drawn, int surfaceW, int surfaceH, int buffer) noexcept
+{
+    const PixelRect surface{ 0, 0, surfaceW, surfaceH };
+    const PixelRect cur = RectIntersect(drawn, surface);
+
+    FrameDamage fd;
+    fd.present = full_ ? surface : RectUnion(prev_, cur);
+    fd.damagedPixels = fd.present.Area();
+    fd.surfacePixels = surface.Area();
+
+    prev_ = cur;
+    full_ = false;
+    Buffer& b = buf_[Index(buffer)];
+    b.drawn = cur;
+    b.full = false;
+
+    ++frames_;
+    totalDamaged_ += fd.damagedPixels;
+    totalSurface_ += fd.surfacePixels;
+    return fd;
+}
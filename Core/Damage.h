@@ -0,0 +1,91 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+// Half-open pixel rectangle [left, right) x [top, bottom)
+struct PixelRect final
+{
+    int left = 0, top = 0, right = 0, bottom = 0;
+
+    [[nodiscard]] bool Empty() const noexcept { return right <= left || bottom <= top; }
+    [[nodiscard]] int Width() const noexcept { return Empty() ? 0 : right - left; }
+    [[nodiscard]] int Height() const noexcept { return Empty() ? 0 : bottom - top; }
+    [[nodiscard]] uint64_t Area() const noexcept { return static_cast<uint64_t>(Width()) * static_cast<uint64_t>(Height()); }
+};
+
+[[nodiscard]] inline PixelRect RectUnion(const PixelRect& a, const PixelRect& b) noexcept
+{
+    if (a.Empty())
+        return b;
+    if (b.Empty())
+        return a;
+    return { std::min(a.left, b.left), std::min(a.top, b.top), std::max(a.right, b.right), std::max(a.bottom, b.bottom) };
+}
+
+[[nodiscard]] inline PixelRect RectIntersect(const PixelRect& a, const PixelRect& b) noexcept
+{
+    const PixelRect r{ std::max(a.left, b.left), std::max(a.top, b.top), std::min(a.right, b.right), std::min(a.bottom, b.bottom) };
+    return r.Empty() ? PixelRect{} : r;
+}
+
+// Damage for one frame
+struct FrameDamage final
+{
+    PixelRect present; // Pixels that changed and must be pushed to the screen
+    uint64_t damagedPixels = 0;
+    uint64_t surfacePixels = 0;
+};
+
+// Tracks stamped bounds across frames so only touched pixels are cleared and presented.
+// With several surfaces presented in rotation, each one is cleared of what it last held
+// while presents are still relative to whatever surface was presented before.
+class DamageTracker final
+{
+public:
+    static constexpr int kMaxBuffers = 3;
+
+    explicit DamageTracker(int buffers = 1) noexcept : buffers_(std::clamp(buffers, 1, kMaxBuffers)) {}
+
+    // Region of the buffer holding its last frame's content; clear it before drawing the new frame
+    [[nodiscard]] PixelRect PendingClear(int surfaceW, int surfaceH, int buffer = 0) const noexcept
+    {
+        const Buffer& b = buf_[Index(buffer)];
+        return b.full ? PixelRect{ 0, 0, surfaceW, surfaceH } : b.drawn;
+    }
+
+    // Records this frame's stamped bounds in the buffer and returns what changed on screen since
+    // the last presented frame
+    FrameDamage EndFrame(const PixelRect& drawn, int surfaceW, int surfaceH, int buffer = 0) noexcept;
+
+    // Forces the next frame to clear and present the whole surface (resize, surface loss)
+    void Invalidate() noexcept
+    {
+        full_ = true;
+        for (Buffer& b : buf_)
+            b.full = true;
+    }
+
+    [[nodiscard]] int Buffers() const noexcept { return buffers_; }
+
+    // Running totals since construction
+    [[nodiscard]] uint64_t Frames() const noexcept { return frames_; }
+    [[nodiscard]] uint64_t TotalDamagedPixels() const noexcept { return totalDamaged_; }
+    [[nodiscard]] uint64_t TotalSurfacePixels() const noexcept { return totalSurface_; }
+
+private:
+    struct Buffer
+    {
+        PixelRect drawn;
+        bool full = true;
+    };
+
+    [[nodiscard]] int Index(int buffer) const noexcept { return std::clamp(buffer, 0, buffers_ - 1); }
+
+    Buffer buf_[kMaxBuffers];
+    int buffers_ = 1;
+    PixelRect prev_;   // Bounds of the last presented frame
+    bool full_ = true;
+    uint64_t frames_ = 0;
+    uint64_t totalDamaged_ = 0;
+    uint64_t totalSurface_ = 0;
+};
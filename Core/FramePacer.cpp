@@ -0,0 +1,59 @@
+#include "Core/FramePacer.h"
+#include <algorithm>
+#include <cmath>
+
+void FramePacer::SetRate(double hz) noexcept
+{
+    hz_ = std::clamp(std::isfinite(hz) ? hz : 60.0, kMinFrameRateHz, kMaxFrameRateHz);
+    period_ = std::chrono::duration_cast<TrailClock::duration>(std::chrono::duration<double>(1.0 / hz_));
+}
+
+TrailClock::time_point FramePacer::Deadline(TrailClock::time_point now) noexcept
+{
+    if (!started_)
+    {
+        next_ = now;
+        started_ = true;
+    }
+    return next_;
+}
+
+int FramePacer::FrameStarted(TrailClock::time_point now) noexcept
+{
+    if (!started_)
+    {
+        next_ = now;
+        started_ = true;
+    }
+
+    next_ += period_;
+    if (next_ > now)
+        return 0;
+
+    // Missed whole periods: keep the phase and take the first deadline still ahead
+    const auto missed = (now - next_) / period_ + 1;
+    next_ += period_ * missed;
+    return static_cast<int>(missed);
+}
+
+void VsyncScheduler::AddFrameCost(TrailClock::duration cost) noexcept
+{
+    costs_[next_] = std::max(cost, TrailClock::duration::zero());
+    next_ = (next_ + 1) % kHistory;
+    count_ = std::min(count_ + 1, kHistory);
+}
+
+TrailClock::duration VsyncScheduler::Lead(TrailClock::duration period) const noexcept
+{
+    if (count_ == 0)
+        return period / 2;
+
+    const TrailClock::duration slowest = *std::max_element(costs_.begin(), costs_.begin() + static_cast<ptrdiff_t>(count_));
+    return std::min<TrailClock::duration>(slowest + kMargin, period * 3 / 4);
+}
+
+TrailClock::time_point VsyncScheduler::WakeTime(TrailClock::time_point now, TrailClock::time_point vblank,
+    TrailClock::duration period) const noexcept
+{
+    return std::max(now, vblank - Lead(period));
+}
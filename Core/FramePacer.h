@@ -0,0 +1,61 @@
+#pragma once
+#include <array>
+#include "Core/TrailBuffer.h"
+
+constexpr double kMinFrameRateHz = 30.0;
+constexpr double kMaxFrameRateHz = 500.0;
+
+// Frame deadlines at a display's refresh rate, kept in nanoseconds so a rate like 144 Hz is
+// not rounded to whole milliseconds. Deadlines are phase-locked to the first one, so waking
+// late does not push the schedule back; a frame that overruns skips the deadlines it missed
+// instead of rendering them back to back.
+class FramePacer final
+{
+public:
+    explicit FramePacer(double hz = 60.0) noexcept { SetRate(hz); }
+
+    // Changes the rate, clamped to [kMinFrameRateHz, kMaxFrameRateHz]; the deadline already
+    // scheduled stands and later ones follow the new period
+    void SetRate(double hz) noexcept;
+
+    [[nodiscard]] double Rate() const noexcept { return hz_; }
+    [[nodiscard]] TrailClock::duration Period() const noexcept { return period_; }
+
+    // Deadline to wait for before the next frame; the first call schedules it at now
+    [[nodiscard]] TrailClock::time_point Deadline(TrailClock::time_point now) noexcept;
+
+    // Called when a frame starts at now: schedules the next deadline one period after the
+    // current one, or the first one after now if the frame started late by a period or more.
+    // Returns the number of deadlines skipped.
+    int FrameStarted(TrailClock::time_point now) noexcept;
+
+private:
+    double hz_ = 60.0;
+    TrailClock::duration period_{};
+    TrailClock::time_point next_{};
+    bool started_ = false;
+};
+
+// Just-in-time wakeups against the compositor's vblank: the render thread wakes a lead time
+// before the next composition, so a frame is presented just in time to be composed instead
+// of waiting most of a refresh period. The lead follows the slowest recent frame cost.
+class VsyncScheduler final
+{
+public:
+    static constexpr size_t kHistory = 32;  // Frame costs the lead is taken over
+    static constexpr auto kMargin = std::chrono::microseconds(500);
+
+    // Records how long a frame took from waking to its present returning
+    void AddFrameCost(TrailClock::duration cost) noexcept;
+
+    // Slowest recent cost plus kMargin, at most 3/4 of the period; half the period until a cost is known
+    [[nodiscard]] TrailClock::duration Lead(TrailClock::duration period) const noexcept;
+
+    // When to start the frame for the composition at vblank; now if that is already past
+    [[nodiscard]] TrailClock::time_point WakeTime(TrailClock::time_point now, TrailClock::time_point vblank,
+        TrailClock::duration period) const noexcept;
+
+private:
+    std::array<TrailClock::duration, kHistory> costs_{};
+    size_t count_ = 0, next_ = 0;
+};
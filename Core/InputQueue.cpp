@@ -0,0 +1,7 @@
+#include "Core/InputQueue.h"
+
+size_t DrainInput(InputQueue& queue, TrailBuffer& trail, TrailClock::time_point now,
+    const TrailSettings& settings) noexcept
+{
+    return DrainInput(queue, trail, now, settings, [](const InputSample&) {});
+}
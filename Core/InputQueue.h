@@ -0,0 +1,33 @@
+#pragma once
+#include "Core/SpscQueue.h"
+#include "Core/Trail.h"
+
+// Cursor position observed by an input thread, stamped when it was read
+struct InputSample final
+{
+    TrailPoint pt;
+    TrailClock::time_point t;
+};
+
+// About a second of 1000 Hz mouse reports, so a stalled frame never drops input
+constexpr size_t kInputQueueSize = 1024;
+using InputQueue = SpscQueue<InputSample, kInputQueueSize>;
+
+// Moves every queued sample into the trail (skipping ones that did not move) and drops
+// samples older than the fade window at now. Returns the number of samples consumed.
+size_t DrainInput(InputQueue& queue, TrailBuffer& trail, TrailClock::time_point now,
+    const TrailSettings& settings) noexcept;
+
+// Same, also handing every consumed sample to observe (e.g. a trace recorder)
+template<typename Fn>
+size_t DrainInput(InputQueue& queue, TrailBuffer& trail, TrailClock::time_point now,
+    const TrailSettings& settings, Fn&& observe) noexcept
+{
+    const size_t count = queue.PopAll([&](const InputSample& s)
+    {
+        observe(s);
+        AppendTrailSample(trail, s.pt, s.t);
+    });
+    ExpireTrail(trail, now, settings);
+    return count;
+}
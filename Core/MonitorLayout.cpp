@@ -0,0 +1,51 @@
+#include "Core/MonitorLayout.h"
+
+MonitorLayout::MonitorLayout(const std::vector<MonitorArea>& monitors)
+{
+    for (const MonitorArea& m : monitors)
+    {
+        if (m.rect.Empty())
+            continue;
+        if (monitors_.size() == kMaxMonitors)
+            break;
+        monitors_.push_back(m);
+    }
+}
+
+int MonitorLayout::IndexAt(int x, int y) const noexcept
+{
+    int nearest = -1;
+    int64_t nearestDist = 0;
+    for (size_t i = 0; i < monitors_.size(); ++i)
+    {
+        const PixelRect& r = monitors_[i].rect;
+        const int64_t dx = x < r.left ? r.left - x : (x >= r.right ? x - (r.right - 1) : 0);
+        const int64_t dy = y < r.top ? r.top - y : (y >= r.bottom ? y - (r.bottom - 1) : 0);
+        const int64_t dist = dx * dx + dy * dy;
+        if (dist == 0)
+            return static_cast<int>(i);
+        if (nearest < 0 || dist < nearestDist)
+        {
+            nearest = static_cast<int>(i);
+            nearestDist = dist;
+        }
+    }
+    return nearest;
+}
+
+PixelRect MonitorLayout::Bounds() const noexcept
+{
+    PixelRect bounds;
+    for (const MonitorArea& m : monitors_)
+        bounds = RectUnion(bounds, m.rect);
+    return bounds;
+}
+
+uint64_t MonitorLayout::CoveredPixels() const noexcept
+{
+    // Displays never overlap; mirrored ones are enumerated as one
+    uint64_t covered = 0;
+    for (const MonitorArea& m : monitors_)
+        covered += m.rect.Area();
+    return covered;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Core/Damage.h"
+
+constexpr int kBaseDpi = 96;        // DPI at 100% scaling
+constexpr size_t kMaxMonitors = 16; // Displays beyond this are ignored
+
+// One display in virtual-screen pixels
+struct MonitorArea final
+{
+    PixelRect rect;
+    int dpi = kBaseDpi;
+    double refreshHz = 60.0;
+
+    [[nodiscard]] bool operator==(const MonitorArea& o) const noexcept
+    {
+        return rect.left == o.rect.left && rect.top == o.rect.top && rect.right == o.rect.right &&
+            rect.bottom == o.rect.bottom && dpi == o.dpi && refreshHz == o.refreshHz;
+    }
+};
+
+// Scales a length given at fromDpi to toDpi, rounded to nearest and never below 1
+[[nodiscard]] inline int ScaleForDpi(int v, int toDpi, int fromDpi = kBaseDpi) noexcept
+{
+    if (v <= 0 || toDpi <= 0 || fromDpi <= 0 || toDpi == fromDpi)
+        return v;
+    const int64_t scaled = (static_cast<int64_t>(v) * toDpi + fromDpi / 2) / fromDpi;
+    return scaled > 1 ? static_cast<int>(scaled) : 1;
+}
+
+// Display arrangement in enumeration order. The virtual screen is only the bounding box of
+// these, so on mixed layouts it includes regions no display shows.
+class MonitorLayout final
+{
+public:
+    MonitorLayout() = default;
+
+    // Drops empty rectangles and keeps at most kMaxMonitors displays
+    explicit MonitorLayout(const std::vector<MonitorArea>& monitors);
+
+    [[nodiscard]] size_t Size() const noexcept { return monitors_.size(); }
+    [[nodiscard]] bool Empty() const noexcept { return monitors_.empty(); }
+    [[nodiscard]] const MonitorArea& operator[](size_t i) const noexcept { return monitors_[i]; }
+
+    // Display containing (x, y), else the nearest one; -1 when there are none
+    [[nodiscard]] int IndexAt(int x, int y) const noexcept;
+
+    // Bounding rectangle of every display
+    [[nodiscard]] PixelRect Bounds() const noexcept;
+
+    // Pixels the displays actually cover; less than Bounds().Area() when they do not tile a rectangle
+    [[nodiscard]] uint64_t CoveredPixels() const noexcept;
+
+    [[nodiscard]] bool operator==(const MonitorLayout& o) const noexcept { return monitors_ == o.monitors_; }
+    [[nodiscard]] bool operator!=(const MonitorLayout& o) const noexcept { return !(*this == o); }
+
+private:
+    std::vector<MonitorArea> monitors_;
+};
@@ -0,0 +1,90 @@
+#include "Core/Presenter.h"
+#include <algorithm>
+
+OffscreenPresenter::OffscreenPresenter(const PixelRect& screen) : screen_(screen)
+{
+    surface_.Resize(screen.Width(), screen.Height());
+}
+
+TrailRenderStats OffscreenPresenter::Present(const Sprite& sprite, const TrailBuffer& trail,
+    TrailClock::time_point now, const TrailSettings& settings)
+{
+    const SurfaceView view = surface_.View();
+    ClearRect(view, damage_.PendingClear(view.w, view.h));
+    const TrailRenderStats stats = renderer_.Render(view, sprite, trail, screen_.left, screen_.top, now, settings);
+    damage_.EndFrame(stats.bounds, view.w, view.h);
+    shows_ = !stats.bounds.Empty();
+    return stats;
+}
+
+bool SpriteVisualPresenter::SyncSprite(const Sprite& sprite)
+{
+    if (sprite.Empty())
+        return false;
+
+    const size_t count = static_cast<size_t>(sprite.w) * sprite.h * sprite.frames;
+    if (uploaded_ && uploadedW_ == sprite.w && uploadedH_ == sprite.h && uploadedFrames_ == sprite.frames &&
+        std::equal(uploadedPx_.begin(), uploadedPx_.end(), sprite.px.data()))
+        return true;
+
+    ++uploads_;
+    uploaded_ = backend_.SetSprite(sprite);
+    uploadedPx_.assign(sprite.px.data(), sprite.px.data() + count);
+    uploadedW_ = sprite.w;
+    uploadedH_ = sprite.h;
+    uploadedFrames_ = sprite.frames;
+    replaceAll_ = true;
+    return uploaded_;
+}
+
+TrailRenderStats SpriteVisualPresenter::Present(const Sprite& sprite, const TrailBuffer& trail,
+    TrailClock::time_point now, const TrailSettings& settings)
+{
+    lut_.Update(settings);
+    int coalesced = 0;
+    CollectStamps(sprite, trail, now, settings, lut_, stamps_, &coalesced);
+    if (!stamps_.empty() && !SyncSprite(sprite))
+        stamps_.clear();
+
+    // Beyond the pool the oldest, faintest stamps go first
+    size_t n = std::min(stamps_.size(), maxVisuals_);
+    if (n > placed_.size())
+        placed_.resize(std::max(placed_.size(), std::min(n, backend_.Reserve(n))));
+    n = std::min(n, placed_.size());
+    const size_t first = stamps_.size() - n;
+
+    TrailRenderStats stats;
+    bool changed = false;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const SpriteStamp& s = stamps_[first + i];
+        const SpriteStamp rel{ s.x - originX_, s.y - originY_, s.alpha, s.frame };
+        if (replaceAll_ || placed_[i] != rel)
+        {
+            backend_.Place(i, rel.x, rel.y, rel.alpha, rel.frame);
+            placed_[i] = rel;
+            ++updates_;
+            changed = true;
+        }
+        stats.bounds = RectUnion(stats.bounds, { s.x, s.y, s.x + sprite.w, s.y + sprite.h });
+    }
+
+    for (size_t i = n; i < shown_; ++i)
+    {
+        backend_.Hide(i);
+        placed_[i] = {};
+        ++updates_;
+        changed = true;
+    }
+
+    if (changed)
+    {
+        backend_.Commit();
+        ++commits_;
+    }
+    shown_ = n;
+    replaceAll_ = false; // Hidden visuals are placed afresh when shown again
+    stats.stamps = static_cast<int>(n);
+    stats.stampsCoalesced = coalesced;
+    return stats;
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <vector>
+#include "Core/Compositor.h"
+#include "Core/TrailRenderer.h"
+
+constexpr size_t kMaxSpriteVisuals = 1024; // Sprite-visual presenters drop the oldest stamps beyond this
+
+// Puts each trail frame on screen. The CPU path rasterizes the trail into a surface; a
+// compositor-side path only moves and fades copies of the cursor sprite it uploaded once.
+class TrailPresenter
+{
+public:
+    virtual ~TrailPresenter() = default;
+
+    // Shows the trail as of now with sprite, the tinted cursor at the target's DPI
+    virtual TrailRenderStats Present(const Sprite& sprite, const TrailBuffer& trail,
+        TrailClock::time_point now, const TrailSettings& settings) = 0;
+
+    // True while an earlier frame may still show trail pixels
+    [[nodiscard]] virtual bool ShowsTrail() const noexcept = 0;
+};
+
+// CPU compositor behind the presenter interface, rendering into an owned surface that covers a
+// fixed screen rectangle. Nothing is shown; tests and benchmarks read the surface.
+class OffscreenPresenter final : public TrailPresenter
+{
+public:
+    explicit OffscreenPresenter(const PixelRect& screen);
+
+    TrailRenderStats Present(const Sprite& sprite, const TrailBuffer& trail,
+        TrailClock::time_point now, const TrailSettings& settings) override;
+
+    [[nodiscard]] bool ShowsTrail() const noexcept override { return shows_; }
+
+    [[nodiscard]] const PixelBuffer& Surface() const noexcept { return surface_; }
+    [[nodiscard]] const PixelRect& Screen() const noexcept { return screen_; }
+
+private:
+    PixelRect screen_;
+    PixelBuffer surface_;
+    TrailRenderer renderer_;
+    DamageTracker damage_;
+    bool shows_ = false;
+};
+
+// Compositor-side pool of sprite instances that SpriteVisualPresenter drives. Visuals are
+// stacked in index order, the highest on top, and blend premultiplied source-over scaled by
+// their opacity. Changes become visible together at Commit.
+class SpriteVisualBackend
+{
+public:
+    virtual ~SpriteVisualBackend() = default;
+
+    // Uploads the image every visual shows, all animation frames; false if it could not be
+    virtual bool SetSprite(const Sprite& sprite) = 0;
+
+    // Grows the pool to count visuals if it can; returns how many there are
+    virtual size_t Reserve(size_t count) = 0;
+
+    // Shows visual i with its top-left corner at (x, y), opacity alpha / 255 and the given frame
+    virtual void Place(size_t i, int x, int y, uint8_t alpha, int frame) = 0;
+
+    virtual void Hide(size_t i) = 0;
+
+    // Publishes everything placed or hidden since the last commit
+    virtual void Commit() = 0;
+};
+
+// Presents the trail as positioned, faded copies of one sprite blended by the compositor, so a
+// frame costs a property update per stamp instead of rasterizing it. Stamps keep RenderTrail's
+// order and alpha; only visuals whose placement changed are touched, and nothing is committed
+// when no visual changed.
+class SpriteVisualPresenter final : public TrailPresenter
+{
+public:
+    explicit SpriteVisualPresenter(SpriteVisualBackend& backend, size_t maxVisuals = kMaxSpriteVisuals) noexcept
+        : backend_(backend), maxVisuals_(maxVisuals) {}
+
+    // Screen position of the backend's (0, 0), e.g. the top-left of the window hosting the visuals
+    void SetOrigin(int x, int y) noexcept
+    {
+        originX_ = x;
+        originY_ = y;
+    }
+
+    TrailRenderStats Present(const Sprite& sprite, const TrailBuffer& trail,
+        TrailClock::time_point now, const TrailSettings& settings) override;
+
+    [[nodiscard]] bool ShowsTrail() const noexcept override { return shown_ > 0; }
+
+    // Running totals since construction
+    [[nodiscard]] uint64_t Updates() const noexcept { return updates_; } // Visuals placed or hidden
+    [[nodiscard]] uint64_t Uploads() const noexcept { return uploads_; } // Sprite uploads
+    [[nodiscard]] uint64_t Commits() const noexcept { return commits_; }
+
+private:
+    // Uploads sprite unless it matches the last upload; false if the backend has no usable sprite
+    bool SyncSprite(const Sprite& sprite);
+
+    SpriteVisualBackend& backend_;
+    size_t maxVisuals_;
+    int originX_ = 0, originY_ = 0;
+    TrailAlphaLut lut_;
+    std::vector<SpriteStamp> stamps_;
+    std::vector<SpriteStamp> placed_; // Per visual, relative to the origin; alpha 0 while hidden
+    size_t shown_ = 0;
+    bool replaceAll_ = false;         // The sprite changed under the placed visuals
+
+    std::vector<uint32_t> uploadedPx_;
+    int uploadedW_ = 0, uploadedH_ = 0, uploadedFrames_ = 0;
+    bool uploaded_ = false;
+
+    uint64_t updates_ = 0, uploads_ = 0, commits_ = 0;
+};
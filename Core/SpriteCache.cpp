@@ -0,0 +1,85 @@
+#include "Core/SpriteCache.h"
+#include <cstring>
+
+static size_t SpriteBytes(const Sprite& s) noexcept
+{
+    return s.px.size() * sizeof(uint32_t);
+}
+
+const Sprite* SpriteCache::Find(const SpriteKey& key) noexcept
+{
+    for (auto it = entries_.begin(); it != entries_.end(); ++it)
+    {
+        if (it->key == key)
+        {
+            if (it != entries_.begin())
+                entries_.splice(entries_.begin(), entries_, it);
+            ++hits_;
+            return &entries_.front().sprite;
+        }
+    }
+    ++misses_;
+    return nullptr;
+}
+
+const Sprite& SpriteCache::Insert(const SpriteKey& key, const uint32_t* src, int srcStride, int hotX, int hotY,
+    int frames, std::vector<int64_t> frameEndUs)
+{
+    for (auto it = entries_.begin(); it != entries_.end(); ++it)
+    {
+        if (it->key == key)
+        {
+            bytes_ -= SpriteBytes(it->sprite);
+            entries_.erase(it);
+            break;
+        }
+    }
+
+    entries_.emplace_front();
+    Entry& e = entries_.front();
+    e.key = key;
+    e.sprite.w = key.w > 0 ? key.w : 0;
+    e.sprite.h = key.h > 0 ? key.h : 0;
+    e.sprite.hotX = hotX;
+    e.sprite.hotY = hotY;
+    e.sprite.frames = frames > 1 && frameEndUs.size() == static_cast<size_t>(frames) ? frames : 1;
+    if (e.sprite.frames > 1)
+        e.sprite.frameEndUs = std::move(frameEndUs);
+
+    // The atlas is contiguous, so the frames copy and tint as one image
+    const int rows = e.sprite.h * e.sprite.frames;
+    e.sprite.px.resize(static_cast<size_t>(e.sprite.w) * rows);
+    for (int y = 0; y < rows; ++y)
+    {
+        std::memcpy(e.sprite.px.data() + static_cast<size_t>(y) * e.sprite.w,
+            src + static_cast<ptrdiff_t>(y) * srcStride, static_cast<size_t>(e.sprite.w) * sizeof(uint32_t));
+    }
+    TintPixels(e.sprite.px.data(), e.sprite.px.size(),
+        static_cast<uint8_t>(key.tint >> 16), static_cast<uint8_t>(key.tint >> 8), static_cast<uint8_t>(key.tint));
+
+    bytes_ += SpriteBytes(e.sprite);
+    Evict();
+    return e.sprite;
+}
+
+void SpriteCache::SetBudget(size_t bytes)
+{
+    budget_ = bytes;
+    Evict();
+}
+
+void SpriteCache::Clear() noexcept
+{
+    entries_.clear();
+    bytes_ = 0;
+}
+
+void SpriteCache::Evict() noexcept
+{
+    while (bytes_ > budget_ && entries_.size() > 1)
+    {
+        bytes_ -= SpriteBytes(entries_.back().sprite);
+        entries_.pop_back();
+        ++evictions_;
+    }
+}
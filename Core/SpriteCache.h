@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <vector>
+#include "Core/Compositor.h"
+
+// Identity of one rasterized, tinted cursor image
+struct SpriteKey final
+{
+    uintptr_t cursor = 0; // Platform cursor handle
+    int w = 0, h = 0;     // Rasterized size
+    uint32_t tint = 0;    // 0xRRGGBB
+    int dpi = 96;
+
+    [[nodiscard]] bool operator==(const SpriteKey& o) const noexcept
+    {
+        return cursor == o.cursor && w == o.w && h == o.h && tint == o.tint && dpi == o.dpi;
+    }
+};
+
+[[nodiscard]] inline uint32_t PackTint(uint8_t r, uint8_t g, uint8_t b) noexcept
+{
+    return (static_cast<uint32_t>(r) << 16) | (static_cast<uint32_t>(g) << 8) | b;
+}
+
+constexpr size_t kDefaultSpriteBudget = 4u << 20; // Pixel bytes kept before evicting
+
+// LRU cache of tinted cursor sprites, so moving between shapes (text beam, hand, arrow)
+// reuses earlier rasterizations instead of redrawing and retinting them. Entries are
+// evicted least recently used first once their pixels exceed the budget; the newest
+// entry is always kept. Sprites returned by Find or Insert stay valid until the next
+// Insert, SetBudget or Clear.
+class SpriteCache final
+{
+public:
+    explicit SpriteCache(size_t budgetBytes = kDefaultSpriteBudget) noexcept : budget_(budgetBytes) {}
+
+    // Cached sprite for key, now most recently used; nullptr (and a counted miss) if absent
+    const Sprite* Find(const SpriteKey& key) noexcept;
+
+    // Copies key.w x key.h premultiplied pixels from src (row pitch srcStride pixels),
+    // tints them with key.tint and caches the result, replacing any entry with the same key.
+    // Animated cursors pass frames > 1 images stacked in src and their cumulative end times.
+    const Sprite& Insert(const SpriteKey& key, const uint32_t* src, int srcStride, int hotX, int hotY,
+        int frames = 1, std::vector<int64_t> frameEndUs = {});
+
+    void SetBudget(size_t bytes);
+    void Clear() noexcept;
+
+    [[nodiscard]] uint64_t Hits() const noexcept { return hits_; }
+    [[nodiscard]] uint64_t Misses() const noexcept { return misses_; }
+    [[nodiscard]] uint64_t Evictions() const noexcept { return evictions_; }
+    [[nodiscard]] size_t Bytes() const noexcept { return bytes_; }
+    [[nodiscard]] size_t Size() const noexcept { return entries_.size(); }
+
+private:
+    struct Entry
+    {
+        SpriteKey key;
+        Sprite sprite;
+    };
+
+    void Evict() noexcept;
+
+    std::list<Entry> entries_; // Most recently used first
+    size_t budget_;
+    size_t bytes_ = 0;
+    uint64_t hits_ = 0, misses_ = 0, evictions_ = 0;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// Each side caches the other side's index and only reloads it when the queue looks
+// full (producer) or empty (consumer), so steady-state traffic touches one shared line.
+template<typename T, size_t N>
+class SpscQueue final
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    static constexpr size_t Capacity() noexcept { return N; }
+
+    // Producer side. Returns false without blocking when the queue is full.
+    bool TryPush(const T& value) noexcept
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - headCache_ == N)
+        {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (tail - headCache_ == N)
+                return false;
+        }
+
+        slots_[tail & (N - 1)] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when the queue is empty.
+    bool TryPop(T& out) noexcept
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tailCache_)
+        {
+            tailCache_ = tail_.load(std::memory_order_acquire);
+            if (head == tailCache_)
+                return false;
+        }
+
+        out = slots_[head & (N - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Hands every queued item to fn in order and frees the slots once
+    // at the end; returns the item count.
+    template<typename Fn>
+    size_t PopAll(Fn&& fn)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        tailCache_ = tail_.load(std::memory_order_acquire);
+        for (size_t i = head; i != tailCache_; ++i)
+            fn(slots_[i & (N - 1)]);
+
+        head_.store(tailCache_, std::memory_order_release);
+        return tailCache_ - head;
+    }
+
+    // Either side; exact only while the other side is idle
+    [[nodiscard]] size_t SizeApprox() const noexcept
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+private:
+    // Consumer-owned
+    alignas(64) std::atomic<size_t> head_{ 0 };
+    size_t tailCache_ = 0;
+
+    // Producer-owned
+    alignas(64) std::atomic<size_t> tail_{ 0 };
+    size_t headCache_ = 0;
+
+    alignas(64) T slots_[N]{};
+};
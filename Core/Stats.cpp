@@ -0,0 +1,301 @@
+#include "Core/Stats.h"
+#include <algorithm>
+
+std::atomic<bool> gStatsEnabled{ false };
+
+struct StatsState final
+{
+    LatencyHistogram stages[static_cast<int>(StatStage::Count)];
+    std::atomic<uint64_t> counters[static_cast<int>(StatCounter::Count)]{};
+    std::atomic<int64_t> gauges[static_cast<int>(StatGauge::Count)]{};
+    std::atomic<uint64_t> jitter[kJitterBuckets]{};
+    std::atomic<int64_t> intervalStartNs{ 0 };
+};
+
+static StatsState sStats;
+
+static int64_t NowNs() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(StatsClock::now().time_since_epoch()).count();
+}
+
+const char* StatStageName(StatStage stage) noexcept
+{
+    switch (stage)
+    {
+        case StatStage::Frame: return "frame";
+        case StatStage::Input: return "input";
+        case StatStage::Tint: return "tint";
+        case StatStage::Composite: return "composite";
+        case StatStage::Wait: return "wait";
+        case StatStage::Queue: return "queue";
+        case StatStage::Present: return "present";
+        case StatStage::Interval: return "interval";
+        case StatStage::Latency: return "latency";
+        default: return "?";
+    }
+}
+
+const char* StatCounterName(StatCounter counter) noexcept
+{
+    switch (counter)
+    {
+        case StatCounter::Frames: return "frames";
+        case StatCounter::Presents: return "presents";
+        case StatCounter::Stamps: return "stamps";
+        case StatCounter::StampsGenerated: return "stamps_generated";
+        case StatCounter::PixelsBlended: return "pixels_blended";
+        case StatCounter::PixelsDecayed: return "pixels_decayed";
+        case StatCounter::InputSamples: return "input_samples";
+        case StatCounter::SpriteHits: return "sprite_hits";
+        case StatCounter::SpriteMisses: return "sprite_misses";
+        case StatCounter::IdleParks: return "idle_parks";
+        default: return "?";
+    }
+}
+
+const char* StatGaugeName(StatGauge gauge) noexcept
+{
+    switch (gauge)
+    {
+        case StatGauge::SamplesAlive: return "samples_alive";
+        case StatGauge::SurfaceBytes: return "surface_bytes";
+        case StatGauge::SpriteCacheBytes: return "sprite_cache_bytes";
+        default: return "?";
+    }
+}
+
+int JitterBucketOf(int64_t deviationNs) noexcept
+{
+    int bucket = 0;
+    while (bucket < kJitterBuckets - 1 && deviationNs >= static_cast<int64_t>(kJitterEdgesUs[bucket]) * 1000)
+        ++bucket;
+    return bucket;
+}
+
+int HistogramCounts::BucketOf(uint64_t ns) noexcept
+{
+    ns = std::min<uint64_t>(ns, (uint64_t(1) << kMaxLog2) - 1);
+    if (ns < 8)
+        return static_cast<int>(ns);
+
+    int msb = 63;
+    while (!(ns >> msb))
+        --msb;
+    const int sub = static_cast<int>((ns >> (msb - 3)) & 7);
+    return (msb - 2) * 8 + sub;
+}
+
+uint64_t HistogramCounts::BucketMid(int bucket) noexcept
+{
+    if (bucket < 8)
+        return static_cast<uint64_t>(bucket);
+
+    const int msb = bucket / 8 + 2;
+    const uint64_t width = uint64_t(1) << (msb - 3);
+    const uint64_t low = (uint64_t(8) + static_cast<uint64_t>(bucket % 8)) * width;
+    return low + width / 2;
+}
+
+uint64_t HistogramCounts::Percentile(double p) const noexcept
+{
+    if (count == 0)
+        return 0;
+
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::clamp(p, 0.0, 1.0) * static_cast<double>(count) + 0.5));
+    uint64_t seen = 0;
+    for (int b = 0; b < kBuckets; ++b)
+    {
+        seen += buckets[b];
+        if (seen >= rank)
+            return std::min(BucketMid(b), maxNs);
+    }
+    return maxNs;
+}
+
+void LatencyHistogram::Record(uint64_t ns) noexcept
+{
+    buckets_[HistogramCounts::BucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t prev = max_.load(std::memory_order_relaxed);
+    while (ns > prev && !max_.compare_exchange_weak(prev, ns, std::memory_order_relaxed))
+    {
+    }
+}
+
+void LatencyHistogram::Drain(HistogramCounts& out, bool reset) noexcept
+{
+    out.count = 0;
+    for (int b = 0; b < HistogramCounts::kBuckets; ++b)
+    {
+        out.buckets[b] = reset ? buckets_[b].exchange(0, std::memory_order_relaxed) : buckets_[b].load(std::memory_order_relaxed);
+        out.count += out.buckets[b];
+    }
+    out.maxNs = reset ? max_.exchange(0, std::memory_order_relaxed) : max_.load(std::memory_order_relaxed);
+    if (reset)
+        count_.store(0, std::memory_order_relaxed);
+}
+
+void SetStatsEnabled(bool enabled) noexcept
+{
+    if (enabled && !StatsEnabled())
+        sStats.intervalStartNs.store(NowNs(), std::memory_order_relaxed);
+    gStatsEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void RecordStageNs(StatStage stage, uint64_t ns) noexcept
+{
+    sStats.stages[static_cast<int>(stage)].Record(ns);
+}
+
+void AddCounterSlow(StatCounter counter, uint64_t value) noexcept
+{
+    sStats.counters[static_cast<int>(counter)].fetch_add(value, std::memory_order_relaxed);
+}
+
+void SetGaugeSlow(StatGauge gauge, int64_t value) noexcept
+{
+    sStats.gauges[static_cast<int>(gauge)].store(value, std::memory_order_relaxed);
+}
+
+void RecordFrameIntervalNs(uint64_t intervalNs, uint64_t targetNs) noexcept
+{
+    sStats.stages[static_cast<int>(StatStage::Interval)].Record(intervalNs);
+    const int64_t deviation = static_cast<int64_t>(intervalNs) - static_cast<int64_t>(targetNs);
+    sStats.jitter[JitterBucketOf(deviation)].fetch_add(1, std::memory_order_relaxed);
+}
+
+StatsSnapshot TakeStatsSnapshot(bool reset) noexcept
+{
+    StatsSnapshot snap;
+    const int64_t now = NowNs();
+    const int64_t start = reset ? sStats.intervalStartNs.exchange(now, std::memory_order_relaxed)
+                                : sStats.intervalStartNs.load(std::memory_order_relaxed);
+    snap.intervalMs = static_cast<uint64_t>(std::max<int64_t>(0, now - start) / 1000000);
+
+    HistogramCounts counts;
+    for (int s = 0; s < static_cast<int>(StatStage::Count); ++s)
+    {
+        sStats.stages[s].Drain(counts, reset);
+        StageSummary& sum = snap.stages[s];
+        sum.count = counts.count;
+        sum.p50Ns = counts.Percentile(0.50);
+        sum.p99Ns = counts.Percentile(0.99);
+        sum.maxNs = counts.maxNs;
+    }
+
+    for (int c = 0; c < static_cast<int>(StatCounter::Count); ++c)
+        snap.counters[c] = reset ? sStats.counters[c].exchange(0, std::memory_order_relaxed)
+                                 : sStats.counters[c].load(std::memory_order_relaxed);
+
+    for (int b = 0; b < kJitterBuckets; ++b)
+        snap.jitter[b] = reset ? sStats.jitter[b].exchange(0, std::memory_order_relaxed)
+                               : sStats.jitter[b].load(std::memory_order_relaxed);
+
+    // Gauges hold the latest reading and are never reset
+    for (int g = 0; g < static_cast<int>(StatGauge::Count); ++g)
+        snap.gauges[g] = sStats.gauges[g].load(std::memory_order_relaxed);
+    return snap;
+}
+
+std::string StatsJsonLine(const StatsSnapshot& snap, uint64_t timeMs)
+{
+    char buf[256];
+    std::string line;
+    std::snprintf(buf, sizeof(buf), "{\"t_ms\":%llu,\"interval_ms\":%llu,\"stages\":{",
+        static_cast<unsigned long long>(timeMs), static_cast<unsigned long long>(snap.intervalMs));
+    line += buf;
+
+    for (int s = 0; s < static_cast<int>(StatStage::Count); ++s)
+    {
+        const StageSummary& sum = snap.stages[s];
+        std::snprintf(buf, sizeof(buf), "%s\"%s\":{\"n\":%llu,\"p50_us\":%.3f,\"p99_us\":%.3f,\"max_us\":%.3f}",
+            s ? "," : "", StatStageName(static_cast<StatStage>(s)), static_cast<unsigned long long>(sum.count),
+            static_cast<double>(sum.p50Ns) / 1e3, static_cast<double>(sum.p99Ns) / 1e3, static_cast<double>(sum.maxNs) / 1e3);
+        line += buf;
+    }
+
+    line += "},\"jitter_us\":{\"edges\":[";
+    for (int b = 0; b < kJitterBuckets - 1; ++b)
+    {
+        std::snprintf(buf, sizeof(buf), "%s%d", b ? "," : "", kJitterEdgesUs[b]);
+        line += buf;
+    }
+    line += "],\"counts\":[";
+    for (int b = 0; b < kJitterBuckets; ++b)
+    {
+        std::snprintf(buf, sizeof(buf), "%s%llu", b ? "," : "", static_cast<unsigned long long>(snap.jitter[b]));
+        line += buf;
+    }
+
+    line += "]},\"counters\":{";
+    for (int c = 0; c < static_cast<int>(StatCounter::Count); ++c)
+    {
+        std::snprintf(buf, sizeof(buf), "%s\"%s\":%llu", c ? "," : "", StatCounterName(static_cast<StatCounter>(c)),
+            static_cast<unsigned long long>(snap.counters[c]));
+        line += buf;
+    }
+
+    line += "},\"gauges\":{";
+    for (int g = 0; g < static_cast<int>(StatGauge::Count); ++g)
+    {
+        std::snprintf(buf, sizeof(buf), "%s\"%s\":%lld", g ? "," : "", StatGaugeName(static_cast<StatGauge>(g)),
+            static_cast<long long>(snap.gauges[g]));
+        line += buf;
+    }
+
+    line += "}}";
+    return line;
+}
+
+bool StatsWriter::Start(std::FILE* file, std::chrono::milliseconds interval)
+{
+    Stop();
+    if (!file)
+        return false;
+
+    file_ = file;
+    stop_ = false;
+    lines_ = 0;
+    start_ = StatsClock::now();
+    TakeStatsSnapshot(true); // Start the first interval now
+    SetStatsEnabled(true);
+
+    thread_ = std::thread([this, interval]
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!wake_.wait_for(lock, interval, [this] { return stop_; }))
+            WriteLine();
+    });
+    return true;
+}
+
+void StatsWriter::Stop() noexcept
+{
+    if (!file_)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable())
+        thread_.join();
+
+    WriteLine();
+    SetStatsEnabled(false);
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+void StatsWriter::WriteLine() noexcept
+{
+    const uint64_t timeMs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(StatsClock::now() - start_).count());
+    const std::string line = StatsJsonLine(TakeStatsSnapshot(true), timeMs);
+    std::fprintf(file_, "%s\n", line.c_str());
+    std::fflush(file_);
+    ++lines_;
+}
@@ -0,0 +1,211 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Always-compiled instrumentation. Recording is gated on one relaxed atomic load, so
+// timers and counters left in hot paths cost a predictable branch when stats are off.
+
+using StatsClock = std::chrono::steady_clock;
+
+// Timed pipeline stages
+enum class StatStage
+{
+    Frame,     // One render-thread frame, wait for a free surface excluded
+    Input,     // Draining queued input into the trail
+    Tint,      // Rebuilding the tinted cursor sprite
+    Composite, // Clearing and blending the trail into the surface
+    Wait,      // Render thread blocked on a free surface
+    Queue,     // Finished frame waiting for the present thread
+    Present,   // UpdateLayeredWindowIndirect
+    Interval,  // Start of one frame to the start of the next
+    Latency,   // Newest input sample in a frame to its present returning
+    Count
+};
+
+// Monotonic event counts
+enum class StatCounter
+{
+    Frames,
+    Presents,
+    Stamps,          // Blended, after coalescing
+    StampsGenerated, // Stepped along the trail, before coalescing and culling
+    PixelsBlended,
+    PixelsDecayed,
+    InputSamples,
+    SpriteHits,   // Tinted cursor found in the sprite cache
+    SpriteMisses, // Tinted cursor rasterized through the platform
+    IdleParks,    // Render loop blocked on input after the trail faded
+    Count
+};
+
+// Last-value readings
+enum class StatGauge
+{
+    SamplesAlive,
+    SurfaceBytes,
+    SpriteCacheBytes,
+    Count
+};
+
+// Frame pacing jitter is the actual frame interval minus the target period, counted in fixed
+// buckets split at these edges: bucket 0 is below the first edge, bucket i is [edge i-1, edge i)
+inline constexpr int kJitterEdgesUs[] = { -1000, -250, -50, 50, 250, 1000, 4000 };
+constexpr int kJitterBuckets = static_cast<int>(sizeof(kJitterEdgesUs) / sizeof(kJitterEdgesUs[0])) + 1;
+
+[[nodiscard]] int JitterBucketOf(int64_t deviationNs) noexcept;
+
+const char* StatStageName(StatStage stage) noexcept;
+const char* StatCounterName(StatCounter counter) noexcept;
+const char* StatGaugeName(StatGauge gauge) noexcept;
+
+// Log-linear latency buckets: exact below 8 ns, then 8 buckets per power of two (12.5% resolution)
+struct HistogramCounts final
+{
+    static constexpr int kMaxLog2 = 40; // Values are clamped just under 2^40 ns, about 18 minutes
+    static constexpr int kBuckets = (kMaxLog2 - 2) * 8;
+
+    uint64_t buckets[kBuckets]{};
+    uint64_t count = 0;
+    uint64_t maxNs = 0;
+
+    [[nodiscard]] static int BucketOf(uint64_t ns) noexcept;
+    [[nodiscard]] static uint64_t BucketMid(int bucket) noexcept;
+
+    // Value below which a fraction p of the samples fall, at bucket resolution; 0 when empty
+    [[nodiscard]] uint64_t Percentile(double p) const noexcept;
+};
+
+// Lock-free histogram; any thread may record while another drains it
+class LatencyHistogram final
+{
+public:
+    void Record(uint64_t ns) noexcept;
+
+    // Copies the counts out, clearing them when reset is set
+    void Drain(HistogramCounts& out, bool reset) noexcept;
+
+private:
+    std::atomic<uint64_t> buckets_[HistogramCounts::kBuckets]{};
+    std::atomic<uint64_t> count_{ 0 };
+    std::atomic<uint64_t> max_{ 0 };
+};
+
+struct StageSummary final
+{
+    uint64_t count = 0;
+    uint64_t p50Ns = 0, p99Ns = 0, maxNs = 0;
+};
+
+// Everything recorded since the previous reset
+struct StatsSnapshot final
+{
+    uint64_t intervalMs = 0;
+    StageSummary stages[static_cast<int>(StatStage::Count)];
+    uint64_t counters[static_cast<int>(StatCounter::Count)]{};
+    int64_t gauges[static_cast<int>(StatGauge::Count)]{};
+    uint64_t jitter[kJitterBuckets]{};
+};
+
+extern std::atomic<bool> gStatsEnabled;
+
+[[nodiscard]] inline bool StatsEnabled() noexcept { return gStatsEnabled.load(std::memory_order_relaxed); }
+void SetStatsEnabled(bool enabled) noexcept;
+
+void RecordStageNs(StatStage stage, uint64_t ns) noexcept;
+void AddCounterSlow(StatCounter counter, uint64_t value) noexcept;
+void SetGaugeSlow(StatGauge gauge, int64_t value) noexcept;
+void RecordFrameIntervalNs(uint64_t intervalNs, uint64_t targetNs) noexcept;
+
+inline void RecordStage(StatStage stage, StatsClock::duration d) noexcept
+{
+    if (StatsEnabled())
+        RecordStageNs(stage, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()));
+}
+
+// Records the interval stage and the jitter against the period the frame was paced to
+inline void RecordFrameInterval(StatsClock::duration interval, StatsClock::duration target) noexcept
+{
+    if (StatsEnabled())
+    {
+        RecordFrameIntervalNs(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count()),
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(target).count()));
+    }
+}
+
+inline void AddCounter(StatCounter counter, uint64_t value = 1) noexcept
+{
+    if (StatsEnabled())
+        AddCounterSlow(counter, value);
+}
+
+inline void SetGauge(StatGauge gauge, int64_t value) noexcept
+{
+    if (StatsEnabled())
+        SetGaugeSlow(gauge, value);
+}
+
+// Summarizes everything recorded since the last reset, optionally starting a new interval
+StatsSnapshot TakeStatsSnapshot(bool reset) noexcept;
+
+// One JSON object per line: interval, per-stage count/p50/p99/max in microseconds, the jitter
+// buckets, counters and gauges
+std::string StatsJsonLine(const StatsSnapshot& snap, uint64_t timeMs);
+
+// Records the lifetime of the scope into a stage histogram
+class ScopedStageTimer final
+{
+public:
+    explicit ScopedStageTimer(StatStage stage) noexcept : stage_(stage), enabled_(StatsEnabled())
+    {
+        if (enabled_)
+            start_ = StatsClock::now();
+    }
+
+    ~ScopedStageTimer()
+    {
+        if (enabled_)
+            RecordStage(stage_, StatsClock::now() - start_);
+    }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    StatStage stage_;
+    bool enabled_;
+    StatsClock::time_point start_{};
+};
+
+// Background thread appending a snapshot line to a file every interval, plus a final
+// line on Stop. Enables stats while running.
+class StatsWriter final
+{
+public:
+    StatsWriter() = default;
+    StatsWriter(const StatsWriter&) = delete;
+    StatsWriter& operator=(const StatsWriter&) = delete;
+    ~StatsWriter() { Stop(); }
+
+    // Takes ownership of file; returns false if it is null
+    bool Start(std::FILE* file, std::chrono::milliseconds interval);
+    void Stop() noexcept;
+
+    [[nodiscard]] uint64_t LinesWritten() const noexcept { return lines_; }
+
+private:
+    void WriteLine() noexcept;
+
+    std::FILE* file_ = nullptr;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+    uint64_t lines_ = 0;
+    StatsClock::time_point start_{};
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Non-owning view over a 32-bit BGRA pixel buffer (top-down rows)
+struct SurfaceView final
+{
+    uint32_t* bits = nullptr;
+    int w = 0, h = 0;
+    int stride = 0; // Row pitch in pixels
+
+    [[nodiscard]] uint32_t* Row(int y) const noexcept { return bits + static_cast<ptrdiff_t>(y) * stride; }
+    [[nodiscard]] bool Empty() const noexcept { return !bits || w <= 0 || h <= 0; }
+};
+
+// Owning 32-bit BGRA pixel buffer used for offscreen rendering
+struct PixelBuffer final
+{
+    std::vector<uint32_t> px;
+    int w = 0, h = 0;
+
+    void Resize(int W, int H)
+    {
+        w = W > 0 ? W : 0;
+        h = H > 0 ? H : 0;
+        px.assign(static_cast<size_t>(w) * h, 0u);
+    }
+
+    void Release() noexcept
+    {
+        px.clear();
+        px.shrink_to_fit();
+        w = h = 0;
+    }
+
+    [[nodiscard]] SurfaceView View() noexcept { return { px.data(), w, h, w }; }
+};
+
+struct PixelRect;
+
+// Fills the whole surface with transparent black
+void ClearSurface(const SurfaceView& s) noexcept;
+
+// Fills the part of r inside the surface with transparent black
+void ClearRect(const SurfaceView& s, const PixelRect& r) noexcept;
@@ -0,0 +1,106 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+constexpr int kPoolMinDim = 128; // Smallest pooled surface edge
+
+// Rounds a surface edge up to its pool bucket: a quarter of the next power of two,
+// so a growing trail reuses a surface for many frames while wasting at most ~25% per edge
+inline int PoolBucketDim(int v) noexcept
+{
+    if (v <= kPoolMinDim)
+        return kPoolMinDim;
+
+    int pow2 = kPoolMinDim;
+    while (pow2 < v)
+        pow2 *= 2;
+
+    const int step = pow2 / 4;
+    return ((v + step - 1) / step) * step;
+}
+
+// Small LRU set of differently sized surfaces. Surface needs w, h and Release();
+// allocation is delegated so the same pool serves GDI DIBs and plain pixel buffers.
+template<typename Surface, size_t N = 4>
+class SurfacePool final
+{
+public:
+    ~SurfacePool() { Release(); }
+
+    // Returns the smallest pooled surface of at least w x h, allocating a bucket-sized one
+    // through alloc(Surface&, W, H) -> bool when none fits. Returns nullptr on failure.
+    template<typename Alloc>
+    Surface* Acquire(int w, int h, Alloc&& alloc)
+    {
+        ++tick_;
+
+        Slot* best = nullptr;
+        for (Slot& slot : slots_)
+        {
+            if (slot.used && slot.surface.w >= w && slot.surface.h >= h &&
+                (!best || Area(slot.surface) < Area(best->surface)))
+                best = &slot;
+        }
+
+        if (!best)
+        {
+            // Reuse an empty slot, otherwise evict the least recently used surface
+            for (Slot& slot : slots_)
+            {
+                if (!best || !slot.used || (best->used && slot.lastUse < best->lastUse))
+                    best = &slot;
+                if (!best->used)
+                    break;
+            }
+
+            best->surface.Release();
+            best->used = false;
+            if (!alloc(best->surface, PoolBucketDim(w), PoolBucketDim(h)))
+                return nullptr;
+
+            best->used = true;
+            ++allocations_;
+        }
+
+        best->lastUse = tick_;
+        return &best->surface;
+    }
+
+    void Release() noexcept
+    {
+        for (Slot& slot : slots_)
+        {
+            slot.surface.Release();
+            slot.used = false;
+        }
+    }
+
+    // Resident pixel memory held by the pool, assuming 32-bit pixels
+    [[nodiscard]] size_t Bytes() const noexcept
+    {
+        size_t bytes = 0;
+        for (const Slot& slot : slots_)
+        {
+            if (slot.used)
+                bytes += static_cast<size_t>(Area(slot.surface)) * 4;
+        }
+        return bytes;
+    }
+
+    [[nodiscard]] uint64_t Allocations() const noexcept { return allocations_; }
+
+private:
+    struct Slot
+    {
+        Surface surface{};
+        uint64_t lastUse = 0;
+        bool used = false;
+    };
+
+    static int64_t Area(const Surface& s) noexcept { return static_cast<int64_t>(s.w) * s.h; }
+
+    std::array<Slot, N> slots_{};
+    uint64_t tick_ = 0;
+    uint64_t allocations_ = 0;
+};
@@ -0,0 +1,116 @@
+#include "Core/SyntheticTrace.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <random>
+
+constexpr float kPi = 3.14159265f;
+
+const char* TracePatternName(TracePattern pattern) noexcept
+{
+    switch (pattern)
+    {
+        case TracePattern::Lines: return "lines";
+        case TracePattern::Circles: return "circles";
+        case TracePattern::Flicks: return "flicks";
+        case TracePattern::Jitter: return "jitter";
+        case TracePattern::Idle: return "idle";
+        default: return "?";
+    }
+}
+
+bool ParseTracePattern(const char* name, TracePattern& out) noexcept
+{
+    for (int i = 0; i < static_cast<int>(TracePattern::Count); ++i)
+    {
+        const char* a = TracePatternName(static_cast<TracePattern>(i));
+        const char* b = name;
+        while (*a && *b && std::tolower(static_cast<unsigned char>(*b)) == *a)
+            ++a, ++b;
+        if (!*a && !*b)
+        {
+            out = static_cast<TracePattern>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<TraceSample> MakeSyntheticTrace(TracePattern pattern, int width, int height,
+    int durationMs, int rateHz, uint32_t seed)
+{
+    std::vector<TraceSample> trace;
+    width = std::max(width, 16);
+    height = std::max(height, 16);
+    rateHz = std::max(rateHz, 1);
+    const int64_t stepUs = 1000000 / rateHz;
+    const int64_t endUs = static_cast<int64_t>(std::max(durationMs, 0)) * 1000;
+    const float cx = width * 0.5f, cy = height * 0.5f;
+
+    std::mt19937 rng(seed);
+    auto clampPoint = [&](float x, float y) -> TrailPoint
+    {
+        return { std::clamp(static_cast<int>(std::lround(x)), 0, width - 1),
+                 std::clamp(static_cast<int>(std::lround(y)), 0, height - 1) };
+    };
+
+    if (pattern == TracePattern::Idle)
+    {
+        trace.push_back({ 0, clampPoint(cx, cy) });
+        return trace;
+    }
+
+    // Flick state: rest at 'from' until flickStart, then ease to 'to' over 60 ms
+    TrailPoint from = clampPoint(cx, cy), to = from;
+    int64_t flickStart = 0;
+    constexpr int64_t kFlickUs = 60000, kRestUs = 300000;
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+    for (int64_t us = 0; us <= endUs; us += stepUs)
+    {
+        const float t = static_cast<float>(us) * 1e-6f;
+        switch (pattern)
+        {
+            case TracePattern::Lines:
+            {
+                // 2000 px/s strokes along a horizontal, a diagonal and a vertical, in turn
+                const float span = std::min(width, height) * 0.8f;
+                const float travel = 2000.f * t;
+                const int stroke = static_cast<int>(travel / span);
+                const float f = std::fmod(travel, span) / span;
+                const float s = (stroke & 1) ? 1.f - f : f;
+                const float dir = static_cast<float>((stroke / 2) % 3) * kPi * 0.25f;
+                trace.push_back({ us, clampPoint(cx + (s - 0.5f) * span * std::cos(dir), cy + (s - 0.5f) * span * std::sin(dir)) });
+                break;
+            }
+            case TracePattern::Circles:
+            {
+                const float r = std::min(width, height) * 0.25f;
+                const float a = 2.f * kPi * 2.f * t; // 2 rev/s
+                trace.push_back({ us, clampPoint(cx + r * std::cos(a), cy + r * std::sin(a)) });
+                break;
+            }
+            case TracePattern::Flicks:
+            {
+                if (us >= flickStart + kFlickUs + kRestUs)
+                {
+                    from = to;
+                    to = clampPoint(unit(rng) * width, unit(rng) * height);
+                    flickStart = us;
+                }
+                const float f = std::clamp(static_cast<float>(us - flickStart) / kFlickUs, 0.f, 1.f);
+                const float e = f * f * (3.f - 2.f * f); // Smoothstep
+                trace.push_back({ us, clampPoint(from.x + (to.x - from.x) * e, from.y + (to.y - from.y) * e) });
+                break;
+            }
+            case TracePattern::Jitter:
+            {
+                trace.push_back({ us, clampPoint(cx + (unit(rng) - 0.5f) * 6.f, cy + (unit(rng) - 0.5f) * 6.f) });
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return trace;
+}
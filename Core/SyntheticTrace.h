@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Core/TraceInput.h"
+
+// Canned cursor motions for headless benchmarks and tests
+enum class TracePattern
+{
+    Lines,   // Straight strokes back and forth across the screen
+    Circles, // Continuous circular motion
+    Flicks,  // Rest, then a fast jump to a random spot
+    Jitter,  // Small random tremor around one point
+    Idle,    // One sample, then nothing
+    Count
+};
+
+const char* TracePatternName(TracePattern pattern) noexcept;
+
+// Case-insensitive name lookup; returns false for unknown names
+bool ParseTracePattern(const char* name, TracePattern& out) noexcept;
+
+// Deterministic trace over a width x height screen sampled at rateHz (a 1000 Hz mouse by
+// default), timestamps starting at 0
+std::vector<TraceSample> MakeSyntheticTrace(TracePattern pattern, int width, int height,
+    int durationMs, int rateHz = 1000, uint32_t seed = 1);
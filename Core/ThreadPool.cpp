@@ -0,0 +1,109 @@
+#include "Core/ThreadPool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(int threads)
+{
+    const int n = std::clamp(threads, 1, kMaxPoolThreads);
+    for (int i = 0; i < n; ++i)
+        queues_.push_back(std::make_unique<Queue>());
+    for (int i = 1; i < n; ++i)
+        workers_.emplace_back([this, i] { WorkerLoop(i); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeLock_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& t : workers_)
+        t.join();
+}
+
+void WorkStealingPool::Run(size_t count, const std::function<void(size_t)>& fn)
+{
+    if (count == 0)
+        return;
+    if (queues_.size() == 1 || count == 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+            fn(i);
+        return;
+    }
+
+    // Queued under each queue's lock, which publishes fn_ to whoever takes the task
+    fn_ = &fn;
+    pending_.store(count, std::memory_order_relaxed);
+    const size_t n = queues_.size();
+    for (size_t q = 0; q < n; ++q)
+    {
+        std::lock_guard<std::mutex> lock(queues_[q]->lock);
+        for (size_t i = q * count / n; i < (q + 1) * count / n; ++i)
+            queues_[q]->tasks.push_back(i);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wakeLock_);
+        ++batch_;
+    }
+    wake_.notify_all();
+
+    Drain(0);
+    while (pending_.load(std::memory_order_acquire) != 0)
+        std::this_thread::yield();
+}
+
+void WorkStealingPool::WorkerLoop(int self)
+{
+    uint64_t seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(wakeLock_);
+            wake_.wait(lock, [&] { return stop_ || batch_ != seen; });
+            if (stop_)
+                return;
+            seen = batch_;
+        }
+        Drain(self);
+    }
+}
+
+void WorkStealingPool::Drain(int self)
+{
+    size_t task;
+    while (TakeOwn(self, task) || Steal(self, task))
+    {
+        (*fn_)(task);
+        pending_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+bool WorkStealingPool::TakeOwn(int self, size_t& task)
+{
+    Queue& q = *queues_[self];
+    std::lock_guard<std::mutex> lock(q.lock);
+    if (q.tasks.empty())
+        return false;
+    task = q.tasks.back();
+    q.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::Steal(int self, size_t& task)
+{
+    const int n = Threads();
+    for (int k = 1; k < n; ++k)
+    {
+        Queue& q = *queues_[(self + k) % n];
+        std::lock_guard<std::mutex> lock(q.lock);
+        if (q.tasks.empty())
+            continue;
+        task = q.tasks.front();
+        q.tasks.pop_front();
+        steals_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+constexpr int kMaxPoolThreads = 64;
+
+// Fixed set of threads running the indices of one batch in parallel. Every thread owns a queue
+// seeded with a contiguous block of the batch; it works from the back of its own and, once that
+// is empty, steals from the front of the others, so uneven tasks balance out. The thread calling
+// Run works on the batch too.
+class WorkStealingPool final
+{
+public:
+    // threads counts the caller, clamped to [1, kMaxPoolThreads]; with 1 batches run inline
+    explicit WorkStealingPool(int threads);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    [[nodiscard]] int Threads() const noexcept { return static_cast<int>(queues_.size()); }
+
+    // Calls fn(i) for every i in [0, count) and returns once all calls have. One batch at a time.
+    void Run(size_t count, const std::function<void(size_t)>& fn);
+
+    // Tasks taken from another thread's queue since construction
+    [[nodiscard]] uint64_t Steals() const noexcept { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
+
+    void WorkerLoop(int self);
+
+    // Runs tasks from the own queue, then stolen ones, until every queue is empty
+    void Drain(int self);
+    bool TakeOwn(int self, size_t& task);
+    bool Steal(int self, size_t& task);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    const std::function<void(size_t)>* fn_ = nullptr;
+    std::atomic<size_t> pending_{ 0 };
+    std::atomic<uint64_t> steals_{ 0 };
+
+    std::mutex wakeLock_;
+    std::condition_variable wake_;
+    uint64_t batch_ = 0;
+    bool stop_ = false;
+};
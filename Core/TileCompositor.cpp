@@ -0,0 +1,84 @@
+#include "Core/TileCompositor.h"
+
+TrailRenderStats TileCompositor::Render(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+    int originX, int originY, TrailClock::time_point now, const TrailSettings& settings, WorkStealingPool& pool)
+{
+    TrailRenderStats stats;
+    if (dst.Empty() || sprite.Empty())
+        return stats;
+
+    lut_.Update(settings);
+    CollectStamps(sprite, trail, now, settings, lut_, stamps_, &stats.stampsCoalesced);
+    stats.stamps = static_cast<int>(stamps_.size());
+
+    uint64_t stamped = 0;
+    for (const SpriteStamp& s : stamps_)
+    {
+        const PixelRect r = SpriteRect(dst, sprite, s.x - originX, s.y - originY);
+        stats.bounds = RectUnion(stats.bounds, r);
+        stamped += r.Area();
+    }
+
+    // Not worth waking the workers for
+    if (pool.Threads() == 1 || stamped < kMinParallelPixels)
+    {
+        for (const SpriteStamp& s : stamps_)
+            stats.pixelsBlended += BlendSprite(dst, sprite, s.x - originX, s.y - originY, s.alpha, s.frame);
+        return stats;
+    }
+
+    // Bin stamps into the tiles they overlap: count per tile, turn counts into end offsets, then
+    // fill each tile from its end with the stamps in reverse, which leaves them ascending
+    const int tilesX = (dst.w + kTileSize - 1) / kTileSize;
+    const int tilesY = (dst.h + kTileSize - 1) / kTileSize;
+    const size_t tiles = static_cast<size_t>(tilesX) * tilesY;
+    const auto forEachTile = [&](const SpriteStamp& s, auto&& fn)
+    {
+        const PixelRect r = SpriteRect(dst, sprite, s.x - originX, s.y - originY);
+        if (r.Empty())
+            return;
+        for (int ty = r.top / kTileSize; ty <= (r.bottom - 1) / kTileSize; ++ty)
+        {
+            for (int tx = r.left / kTileSize; tx <= (r.right - 1) / kTileSize; ++tx)
+                fn(static_cast<size_t>(ty) * tilesX + tx);
+        }
+    };
+
+    tileStart_.assign(tiles + 1, 0);
+    for (const SpriteStamp& s : stamps_)
+        forEachTile(s, [&](size_t t) { ++tileStart_[t]; });
+    for (size_t t = 1; t <= tiles; ++t)
+        tileStart_[t] += tileStart_[t - 1];
+    tileStamps_.resize(tileStart_[tiles]);
+    for (size_t i = stamps_.size(); i-- > 0;)
+        forEachTile(stamps_[i], [&](size_t t) { tileStamps_[--tileStart_[t]] = static_cast<uint32_t>(i); });
+
+    busyTiles_.clear();
+    for (size_t t = 0; t < tiles; ++t)
+    {
+        if (tileStart_[t + 1] > tileStart_[t])
+            busyTiles_.push_back(static_cast<uint32_t>(t));
+    }
+
+    // Each tile is a view of its own pixels, so BlendSprite clips every stamp to the tile
+    tileBlended_.assign(busyTiles_.size(), 0);
+    pool.Run(busyTiles_.size(), [&](size_t k)
+    {
+        const uint32_t t = busyTiles_[k];
+        const int x0 = static_cast<int>(t % tilesX) * kTileSize;
+        const int y0 = static_cast<int>(t / tilesX) * kTileSize;
+        const SurfaceView tile{ dst.Row(y0) + x0, std::min(kTileSize, dst.w - x0), std::min(kTileSize, dst.h - y0), dst.stride };
+        uint64_t blended = 0;
+        for (uint32_t j = tileStart_[t]; j < tileStart_[t + 1]; ++j)
+        {
+            const SpriteStamp& s = stamps_[tileStamps_[j]];
+            blended += BlendSprite(tile, sprite, s.x - originX - x0, s.y - originY - y0, s.alpha, s.frame);
+        }
+        tileBlended_[k] = blended;
+    });
+
+    for (const uint64_t blended : tileBlended_)
+        stats.pixelsBlended += blended;
+    ++parallelFrames_;
+    return stats;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <vector>
+#include "Core/Compositor.h"
+#include "Core/ThreadPool.h"
+#include "Core/TrailStepper.h"
+
+constexpr int kTileSize = 128;                   // Edge of a surface tile in px
+constexpr uint64_t kMinParallelPixels = 1 << 16; // Stamped pixels below which a frame is blended on one thread
+
+// Stamping compositor that splits the surface into kTileSize tiles and blends them in parallel.
+// Stamps are binned into every tile their sprite overlaps, keeping oldest-to-newest order within
+// each tile, so every pixel sees the same blends in the same order as RenderTrail and the result
+// is identical. Frames with little stamped area, or a pool of one thread, blend in one pass.
+class TileCompositor final
+{
+public:
+    TrailRenderStats Render(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+        int originX, int originY, TrailClock::time_point now, const TrailSettings& settings,
+        WorkStealingPool& pool);
+
+    // Frames split into tiles since construction
+    [[nodiscard]] uint64_t ParallelFrames() const noexcept { return parallelFrames_; }
+
+private:
+    TrailAlphaLut lut_;
+    std::vector<SpriteStamp> stamps_;
+    std::vector<uint32_t> tileStart_;  // Per tile, offset of its first entry in tileStamps_; one extra at the end
+    std::vector<uint32_t> tileStamps_; // Stamp indices grouped by tile, ascending within each
+    std::vector<uint32_t> busyTiles_;  // Tiles with at least one stamp
+    std::vector<uint64_t> tileBlended_;
+    uint64_t parallelFrames_ = 0;
+};
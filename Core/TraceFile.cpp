@@ -0,0 +1,259 @@
+#include "Core/TraceFile.h"
+#include <cstring>
+
+constexpr size_t kTraceFlushBytes = 64 * 1024;
+constexpr auto kTraceFlushInterval = std::chrono::milliseconds(50);
+
+static void PutVarint(std::vector<uint8_t>& out, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+static uint64_t ZigZag(int64_t v) noexcept
+{
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+static int64_t UnZigZag(uint64_t v) noexcept
+{
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+void WriteTraceHeader(std::vector<uint8_t>& out, const TraceHeader& header)
+{
+    const uint8_t magic[4] = { 'C', 'B', 'T', 'R' };
+    out.insert(out.end(), magic, magic + 4);
+    out.push_back(static_cast<uint8_t>(header.version));
+    out.push_back(static_cast<uint8_t>(header.version >> 8));
+    out.push_back(static_cast<uint8_t>(kTraceHeaderBytes));
+    out.push_back(0);
+    for (int i = 0; i < 8; ++i)
+        out.push_back(static_cast<uint8_t>(static_cast<uint64_t>(header.startUnixUs) >> (8 * i)));
+}
+
+bool ParseTraceHeader(const uint8_t* data, size_t size, TraceHeader& header) noexcept
+{
+    if (size < kTraceHeaderBytes || std::memcmp(data, "CBTR", 4) != 0)
+        return false;
+
+    header.version = static_cast<uint16_t>(data[4] | (data[5] << 8));
+    const size_t headerBytes = static_cast<size_t>(data[6] | (data[7] << 8));
+    if (header.version != kTraceVersion || headerBytes != kTraceHeaderBytes)
+        return false;
+
+    uint64_t start = 0;
+    for (int i = 0; i < 8; ++i)
+        start |= static_cast<uint64_t>(data[8 + i]) << (8 * i);
+    header.startUnixUs = static_cast<int64_t>(start);
+    return true;
+}
+
+void TraceEncoder::Append(std::vector<uint8_t>& out, const TraceSample& s)
+{
+    const int64_t dt = s.us - prev_.us;
+    const int64_t dx = static_cast<int64_t>(s.pt.x) - prev_.pt.x;
+    const int64_t dy = static_cast<int64_t>(s.pt.y) - prev_.pt.y;
+    const bool small = dx >= -8 && dx <= 7 && dy >= -8 && dy <= 7;
+    const bool changed = s.shape != prev_.shape || s.visible != prev_.visible;
+
+    PutVarint(out, (ZigZag(dt - prevDt_) << 2) | (small ? 2u : 0u) | (changed ? 1u : 0u));
+    if (small)
+    {
+        out.push_back(static_cast<uint8_t>((dx + 8) | ((dy + 8) << 4)));
+    }
+    else
+    {
+        PutVarint(out, ZigZag(dx));
+        PutVarint(out, ZigZag(dy));
+    }
+    if (changed)
+        PutVarint(out, (static_cast<uint64_t>(s.shape) << 1) | (s.visible ? 1u : 0u));
+
+    prev_ = s;
+    prevDt_ = dt;
+}
+
+bool TraceDecoder::ReadVarint(uint64_t& v) noexcept
+{
+    v = 0;
+    for (int shift = 0; shift < 64 && cur_ < end_; shift += 7)
+    {
+        const uint8_t b = *cur_++;
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+bool TraceDecoder::Next(TraceSample& sample) noexcept
+{
+    const uint8_t* const begin = cur_;
+    TraceSample s = prev_;
+    uint64_t tag;
+    if (!ReadVarint(tag))
+    {
+        cur_ = begin;
+        return false;
+    }
+
+    int64_t dx, dy;
+    if (tag & 2)
+    {
+        if (cur_ == end_)
+        {
+            cur_ = begin;
+            return false;
+        }
+        dx = static_cast<int64_t>(*cur_ & 0xF) - 8;
+        dy = static_cast<int64_t>(*cur_ >> 4) - 8;
+        ++cur_;
+    }
+    else
+    {
+        uint64_t zx, zy;
+        if (!ReadVarint(zx) || !ReadVarint(zy))
+        {
+            cur_ = begin;
+            return false;
+        }
+        dx = UnZigZag(zx);
+        dy = UnZigZag(zy);
+    }
+
+    if (tag & 1)
+    {
+        uint64_t state;
+        if (!ReadVarint(state))
+        {
+            cur_ = begin;
+            return false;
+        }
+        s.shape = static_cast<uint16_t>(state >> 1);
+        s.visible = (state & 1) != 0;
+    }
+
+    const int64_t dt = prevDt_ + UnZigZag(tag >> 2);
+    s.us = prev_.us + dt;
+    s.pt.x = static_cast<int>(prev_.pt.x + dx);
+    s.pt.y = static_cast<int>(prev_.pt.y + dy);
+
+    prev_ = s;
+    prevDt_ = dt;
+    sample = s;
+    return true;
+}
+
+bool LoadTraceFile(const char* path, std::vector<TraceSample>& out, TraceHeader* header)
+{
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f)
+        return false;
+
+    std::vector<uint8_t> data;
+    uint8_t chunk[16384];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0)
+        data.insert(data.end(), chunk, chunk + n);
+    std::fclose(f);
+
+    TraceHeader h;
+    if (!ParseTraceHeader(data.data(), data.size(), h))
+        return false;
+    if (header)
+        *header = h;
+
+    TraceDecoder decoder(data.data() + kTraceHeaderBytes, data.size() - kTraceHeaderBytes);
+    TraceSample s;
+    while (decoder.Next(s))
+        out.push_back(s);
+    return true;
+}
+
+bool TraceRecorder::Start(std::FILE* file, TrailClock::time_point start)
+{
+    Stop();
+    if (!file)
+        return false;
+
+    file_ = file;
+    start_ = start;
+    stop_ = false;
+    recorded_.store(0);
+    dropped_.store(0);
+    encoder_.Reset();
+    buffer_.clear();
+    buffer_.reserve(kTraceFlushBytes + 64);
+
+    // Wall clock is only stored for matching a recording to a report, so a system_clock read suffices
+    TraceHeader header;
+    header.startUnixUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    WriteTraceHeader(buffer_, header);
+    bytes_.store(0);
+
+    thread_ = std::thread([this]
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto lastWrite = TrailClock::now();
+        while (!wake_.wait_for(lock, std::chrono::milliseconds(10), [this] { return stop_; }))
+        {
+            queue_.PopAll([this](const TraceSample& s) { encoder_.Append(buffer_, s); });
+            const auto now = TrailClock::now();
+            if (buffer_.size() >= kTraceFlushBytes || now - lastWrite >= kTraceFlushInterval)
+            {
+                Flush();
+                lastWrite = now;
+            }
+        }
+    });
+    return true;
+}
+
+void TraceRecorder::Stop() noexcept
+{
+    if (!file_)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable())
+        thread_.join();
+
+    queue_.PopAll([this](const TraceSample& s) { encoder_.Append(buffer_, s); });
+    Flush();
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+void TraceRecorder::Record(TrailPoint pt, TrailClock::time_point t, uint16_t shape, bool visible) noexcept
+{
+    TraceSample s;
+    s.us = std::chrono::duration_cast<std::chrono::microseconds>(t - start_).count();
+    s.pt = pt;
+    s.shape = shape;
+    s.visible = visible;
+    if (queue_.TryPush(s))
+        recorded_.fetch_add(1, std::memory_order_relaxed);
+    else
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Flushed through to the OS each time so a crash loses at most one interval of samples
+void TraceRecorder::Flush() noexcept
+{
+    if (buffer_.empty())
+        return;
+    std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+    std::fflush(file_);
+    bytes_.fetch_add(buffer_.size(), std::memory_order_relaxed);
+    buffer_.clear();
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Core/TraceInput.h"
+
+// Binary cursor trace: a 16-byte header followed by delta-coded samples.
+//
+// Header: "CBTR", u16 version, u16 header size, i64 wall-clock start in Unix microseconds
+// (all little-endian). Each sample is a varint of (zigzag(dt - previous dt) << 2 | small << 1
+// | changed), then dx/dy from the previous position as one nibble-packed byte when both fit
+// in [-8, 7] (small) or as two zigzag varints, then a varint of (shape << 1 | visible) only
+// when either changed. Steady 1000 Hz motion costs two or three bytes per sample.
+constexpr uint16_t kTraceVersion = 1;
+constexpr size_t kTraceHeaderBytes = 16;
+
+struct TraceHeader final
+{
+    uint16_t version = kTraceVersion;
+    int64_t startUnixUs = 0;
+};
+
+void WriteTraceHeader(std::vector<uint8_t>& out, const TraceHeader& header);
+
+// Returns false when data does not start with a trace header this version can read
+bool ParseTraceHeader(const uint8_t* data, size_t size, TraceHeader& header) noexcept;
+
+// Appends samples to a byte stream; samples must be appended in recording order
+class TraceEncoder final
+{
+public:
+    void Append(std::vector<uint8_t>& out, const TraceSample& sample);
+    void Reset() noexcept { *this = TraceEncoder(); }
+
+private:
+    TraceSample prev_;
+    int64_t prevDt_ = 0;
+};
+
+// Reads samples back from the bytes after the header
+class TraceDecoder final
+{
+public:
+    TraceDecoder(const uint8_t* data, size_t size) noexcept : cur_(data), end_(data + size) {}
+
+    // Returns false at the end of the data or on a truncated final sample
+    bool Next(TraceSample& sample) noexcept;
+
+    [[nodiscard]] bool AtEnd() const noexcept { return cur_ == end_; }
+
+private:
+    bool ReadVarint(uint64_t& v) noexcept;
+
+    const uint8_t* cur_;
+    const uint8_t* end_;
+    TraceSample prev_;
+    int64_t prevDt_ = 0;
+};
+
+// Decodes a whole trace file. A recording cut short keeps every complete sample.
+bool LoadTraceFile(const char* path, std::vector<TraceSample>& out, TraceHeader* header = nullptr);
+
+// Streams samples to a trace file from a background thread. Record is wait-free and may be
+// called from one thread only; samples are dropped (and counted) if the writer falls behind.
+class TraceRecorder final
+{
+public:
+    TraceRecorder() = default;
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+    ~TraceRecorder() { Stop(); }
+
+    // Takes ownership of file; timestamps are recorded relative to start. Returns false if file is null.
+    bool Start(std::FILE* file, TrailClock::time_point start);
+
+    // Flushes every queued sample, then closes the file
+    void Stop() noexcept;
+
+    [[nodiscard]] bool Recording() const noexcept { return file_ != nullptr; }
+
+    void Record(TrailPoint pt, TrailClock::time_point t, uint16_t shape, bool visible) noexcept;
+
+    [[nodiscard]] uint64_t Recorded() const noexcept { return recorded_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t Dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t BytesWritten() const noexcept { return bytes_.load(std::memory_order_relaxed); }
+
+private:
+    void Flush() noexcept;
+
+    std::FILE* file_ = nullptr;
+    TrailClock::time_point start_{};
+    SpscQueue<TraceSample, 4096> queue_;
+    TraceEncoder encoder_;
+    std::vector<uint8_t> buffer_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+    std::atomic<uint64_t> recorded_{ 0 };
+    std::atomic<uint64_t> dropped_{ 0 };
+    std::atomic<uint64_t> bytes_{ 0 };
+};
@@ -0,0 +1,37 @@
+#include "Core/TraceInput.h"
+
+void TraceInputThread::Start(std::vector<TraceSample> trace, InputQueue& queue, TrailClock::time_point start, double speed)
+{
+    Stop();
+    stop_.store(false);
+    done_.store(false);
+    pushed_.store(0);
+    dropped_.store(0);
+
+    const double scale = speed > 0.0 ? 1.0 / speed : 1.0;
+    thread_ = std::thread([this, trace = std::move(trace), &queue, start, scale]
+    {
+        for (const TraceSample& s : trace)
+        {
+            if (stop_.load(std::memory_order_relaxed))
+                break;
+
+            const auto t = start + std::chrono::duration_cast<TrailClock::duration>(
+                std::chrono::duration<double, std::micro>(static_cast<double>(s.us) * scale));
+            std::this_thread::sleep_until(t);
+
+            if (queue.TryPush({ s.pt, t }))
+                pushed_.fetch_add(1, std::memory_order_relaxed);
+            else
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        done_.store(true, std::memory_order_release);
+    });
+}
+
+void TraceInputThread::Stop() noexcept
+{
+    stop_.store(true);
+    if (thread_.joinable())
+        thread_.join();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "Core/InputQueue.h"
+
+// One recorded cursor position, timestamped relative to the start of its trace
+struct TraceSample final
+{
+    int64_t us = 0;
+    TrailPoint pt;
+    uint16_t shape = 0;  // Recorder-assigned cursor image id, 0 when unknown
+    bool visible = true; // Cursor was showing
+};
+
+// Replays a recorded trace into an InputQueue from its own thread, paced by the sample
+// timestamps. Stands in for the Win32 raw-input thread where there is no desktop, and
+// drops samples the same way when the consumer falls behind.
+class TraceInputThread final
+{
+public:
+    TraceInputThread() = default;
+    TraceInputThread(const TraceInputThread&) = delete;
+    TraceInputThread& operator=(const TraceInputThread&) = delete;
+    ~TraceInputThread() { Stop(); }
+
+    // Sample i is pushed at start + trace[i].us / speed, carrying that time as its timestamp
+    void Start(std::vector<TraceSample> trace, InputQueue& queue, TrailClock::time_point start, double speed = 1.0);
+
+    // Abandons the rest of the trace and joins the thread
+    void Stop() noexcept;
+
+    [[nodiscard]] bool Done() const noexcept { return done_.load(std::memory_order_acquire); }
+    [[nodiscard]] uint64_t Pushed() const noexcept { return pushed_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t Dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    std::thread thread_;
+    std::atomic<bool> stop_{ false };
+    std::atomic<bool> done_{ false };
+    std::atomic<uint64_t> pushed_{ 0 };
+    std::atomic<uint64_t> dropped_{ 0 };
+};
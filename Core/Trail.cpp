@@ -0,0 +1,31 @@
+#include "Core/Trail.h"
+
+void AppendTrailSample(TrailBuffer& trail, TrailPoint pt, TrailClock::time_point t) noexcept
+{
+    bool add = trail.Empty();
+    if (!add)
+    {
+        const TrailPoint p = trail.Back();
+        const int dx = pt.x - p.x;
+        const int dy = pt.y - p.y;
+
+        // Should add a new sample if the cursor has moved at least 1px
+        add = ((dx * dx + dy * dy) >= 1);
+    }
+
+    if (add)
+        trail.Push(pt, t);
+}
+
+void UpdateTrail(TrailBuffer& trail, TrailPoint ptNow,
+    TrailClock::time_point now, const TrailSettings& settings) noexcept
+{
+    AppendTrailSample(trail, ptNow, now);
+    ExpireTrail(trail, now, settings);
+}
+
+void ExpireTrail(TrailBuffer& trail, TrailClock::time_point now,
+    const TrailSettings& settings) noexcept
+{
+    trail.ExpireOlderThan(now, settings.fadeMs + 50.f);
+}
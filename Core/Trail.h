@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include "Core/TrailBuffer.h"
+
+// Constants
+constexpr int kMaxTrailSize = 500; // Max count of trail samples
+constexpr int kSubpixelGrid = 4;   // Stamp positions per pixel and axis for the subpixel method
+
+// How trail segments are rasterized
+enum class RenderMethod
+{
+    Stamp,   // Blend the cursor once per pixel of travel
+    Swept,   // Integrate the cursor analytically along each segment
+    Subpixel // Blend pre-shifted cursor copies at fractional positions, stampSpacing px apart
+};
+
+// Tunables exposed as launch arguments
+struct TrailSettings final
+{
+    float sensitivity = 0.03f; // Fade intensity relative to cursor speed
+    float fadeMs = 50.f;       // How long each sample takes to fade out
+    uint8_t maxAlpha = 10;     // Trail starting opacity
+    uint8_t tintR = 255, tintG = 255, tintB = 255; // Optional tint applied to trail
+    RenderMethod method = RenderMethod::Stamp;
+    float stampSpacing = 2.f;  // Subpixel method: px of travel between stamps
+    bool accumulate = false;   // Fade the previous frame in place and stamp only new motion
+    bool coalesce = false;     // Merge consecutive stamps at the same position into one blend
+    uint8_t cullAlpha = 0;     // Drop stamps fainter than this after merging (below 3 they are always dropped)
+    uint8_t errorBudget = 0;   // Stamp method: widen steps while a stamp stays this faint (0 = one stamp per pixel)
+};
+
+// Appends a sample if it is at least 1px away from the newest one
+void AppendTrailSample(TrailBuffer& trail, TrailPoint pt, TrailClock::time_point t) noexcept;
+
+// Appends the current cursor position if it moved and drops expired samples
+void UpdateTrail(TrailBuffer& trail, TrailPoint ptNow,
+    TrailClock::time_point now, const TrailSettings& settings) noexcept;
+
+// Drops samples older than the fade window
+void ExpireTrail(TrailBuffer& trail, TrailClock::time_point now,
+    const TrailSettings& settings) noexcept;
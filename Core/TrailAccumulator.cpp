@@ -0,0 +1,105 @@
+#include "Core/TrailAccumulator.h"
+#include <algorithm>
+#include <cmath>
+
+void TrailAccumulator::Reset() noexcept
+{
+    std::fill(live_.begin(), live_.end(), uint8_t(0));
+    surfaceW_ = surfaceH_ = 0;
+    primed_ = false;
+}
+
+void TrailAccumulator::MarkLive(const PixelRect& r) noexcept
+{
+    if (r.Empty())
+        return;
+
+    for (int ty = r.top / kTileSize; ty <= (r.bottom - 1) / kTileSize; ++ty)
+        for (int tx = r.left / kTileSize; tx <= (r.right - 1) / kTileSize; ++tx)
+            live_[static_cast<size_t>(ty) * tilesX_ + tx] = 1;
+}
+
+PixelRect TrailAccumulator::LiveBounds() const noexcept
+{
+    PixelRect bounds;
+    for (int ty = 0; ty < tilesY_; ++ty)
+    {
+        for (int tx = 0; tx < tilesX_; ++tx)
+        {
+            if (live_[static_cast<size_t>(ty) * tilesX_ + tx])
+                bounds = RectUnion(bounds, { tx * kTileSize, ty * kTileSize,
+                    std::min((tx + 1) * kTileSize, surfaceW_), std::min((ty + 1) * kTileSize, surfaceH_) });
+        }
+    }
+    return bounds;
+}
+
+TrailRenderStats TrailAccumulator::Render(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+    int originX, int originY, TrailClock::time_point now, const TrailSettings& settings)
+{
+    TrailRenderStats stats;
+    if (dst.Empty() || sprite.Empty())
+        return stats;
+
+    // A new or resized surface has unknown contents
+    if (!primed_ || dst.w != surfaceW_ || dst.h != surfaceH_)
+    {
+        ClearSurface(dst);
+        surfaceW_ = dst.w;
+        surfaceH_ = dst.h;
+        tilesX_ = (dst.w + kTileSize - 1) / kTileSize;
+        tilesY_ = (dst.h + kTileSize - 1) / kTileSize;
+        live_.assign(static_cast<size_t>(tilesX_) * tilesY_, uint8_t(0));
+        lastFrame_ = now;
+        lastStamped_ = {};
+        primed_ = true;
+        stats.bounds = { 0, 0, dst.w, dst.h };
+    }
+
+    // Exponential fade with time constant fadeMs / 2, which leaves the same total
+    // visible energy as the redraw path's linear fade over fadeMs
+    const float dtMs = std::chrono::duration<float, std::milli>(now - lastFrame_).count();
+    lastFrame_ = now;
+    if (dtMs > 0.f)
+    {
+        const float keepF = std::exp(-2.f * dtMs / std::max(settings.fadeMs, 1.f));
+        const uint32_t keep = static_cast<uint32_t>(std::min(keepF * 65536.f, 65535.f));
+        const uint32_t seed = ++frame_ * 0xC2B2AE35u;
+        for (int ty = 0; ty < tilesY_; ++ty)
+        {
+            for (int tx = 0; tx < tilesX_; ++tx)
+            {
+                uint8_t& live = live_[static_cast<size_t>(ty) * tilesX_ + tx];
+                if (!live)
+                    continue;
+
+                const PixelRect tile{ tx * kTileSize, ty * kTileSize,
+                    std::min((tx + 1) * kTileSize, dst.w), std::min((ty + 1) * kTileSize, dst.h) };
+                live = DecayRect(dst, tile, keep, seed) ? 1 : 0;
+                stats.pixelsDecayed += tile.Area();
+                stats.bounds = RectUnion(stats.bounds, tile);
+            }
+        }
+    }
+
+    // Samples are pushed in time order, so the unstamped ones form a suffix
+    size_t first = trail.Size();
+    while (first > 0 && trail.TimePoint(first - 1) > lastStamped_)
+        --first;
+    if (first == trail.Size())
+        return stats;
+
+    // Re-include the last stamped sample so the segment leading to the new ones is drawn
+    fresh_.Clear();
+    for (size_t i = first > 0 ? first - 1 : 0; i < trail.Size(); ++i)
+        fresh_.Push(trail.Point(i), trail.TimePoint(i));
+    lastStamped_ = trail.TimePoint(trail.Size() - 1);
+
+    const TrailRenderStats drawn = renderer_.Render(dst, sprite, fresh_, originX, originY, now, settings);
+    MarkLive(drawn.bounds);
+    stats.stamps = drawn.stamps;
+    stats.stampsCoalesced = drawn.stampsCoalesced;
+    stats.pixelsBlended = drawn.pixelsBlended;
+    stats.bounds = RectUnion(stats.bounds, drawn.bounds);
+    return stats;
+}
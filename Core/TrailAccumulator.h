@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+#include "Core/TrailRenderer.h"
+
+// Persistent-surface trail rendering: instead of clearing and re-stamping every live
+// sample, each frame fades what is already on the surface and stamps only the segments
+// added since the previous frame. Fading is tracked per tile so only tiles that still
+// hold visible pixels are touched.
+class TrailAccumulator final
+{
+public:
+    static constexpr int kTileSize = 64;
+
+    // Same contract as TrailRenderer::Render, except dst must be the same surface every
+    // frame and is not cleared by the caller. The returned bounds cover every pixel that
+    // changed (stamped or faded); pixelsDecayed counts the faded tile area.
+    TrailRenderStats Render(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+        int originX, int originY, TrailClock::time_point now, const TrailSettings& settings);
+
+    // Forgets the surface contents; the next Render clears it and restamps the whole trail
+    void Reset() noexcept;
+
+    // Rectangle covering the tiles that still hold visible pixels
+    [[nodiscard]] PixelRect LiveBounds() const noexcept;
+
+private:
+    void MarkLive(const PixelRect& r) noexcept;
+
+    TrailRenderer renderer_;
+    TrailBuffer fresh_{ kMaxTrailSize };  // Samples not yet stamped, plus the one before them
+    std::vector<uint8_t> live_;           // Per tile: holds visible pixels
+    int tilesX_ = 0, tilesY_ = 0;
+    int surfaceW_ = 0, surfaceH_ = 0;
+    TrailClock::time_point lastFrame_{};
+    TrailClock::time_point lastStamped_{}; // Timestamp of the newest sample already on the surface
+    bool primed_ = false;
+    uint32_t frame_ = 0;
+};
@@ -0,0 +1,114 @@
+#include "Core/TrailBuffer.h"
+#include <algorithm>
+#include <cmath>
+
+constexpr int64_t kRebaseAfterUs = int64_t(1) << 30; // ~18 minutes
+constexpr int64_t kRebaseKeepUs = int64_t(1) << 24;  // Headroom kept behind now, ~17 s
+
+TrailBuffer::TrailBuffer(size_t maxSamples)
+{
+    maxSize_ = std::max<size_t>(maxSamples, 1);
+    size_t cap = 1;
+    while (cap < maxSize_)
+        cap <<= 1;
+
+    mask_ = cap - 1;
+    x_.reset(new int32_t[cap]());
+    y_.reset(new int32_t[cap]());
+    t_.reset(new int32_t[cap]());
+}
+
+int32_t TrailBuffer::ToUs(TrailClock::time_point t) const noexcept
+{
+    const int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(t - epoch_).count();
+    return static_cast<int32_t>(std::clamp<int64_t>(us, INT32_MIN, INT32_MAX));
+}
+
+void TrailBuffer::Rebase(TrailClock::time_point now) noexcept
+{
+    if (!hasEpoch_)
+    {
+        epoch_ = now;
+        hasEpoch_ = true;
+        return;
+    }
+
+    const int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(now - epoch_).count();
+    if (us < kRebaseAfterUs)
+        return;
+
+    // Live samples are at most a second or so old, so they stay in range after the shift
+    const int64_t shift = us - kRebaseKeepUs;
+    epoch_ += std::chrono::microseconds(shift);
+    for (size_t i = 0; i < size_; ++i)
+    {
+        int32_t& t = t_[(head_ + i) & mask_];
+        t = static_cast<int32_t>(std::max<int64_t>(t - shift, INT32_MIN));
+    }
+}
+
+void TrailBuffer::Push(TrailPoint pt, TrailClock::time_point t) noexcept
+{
+    Rebase(t);
+    if (size_ == maxSize_)
+        PopFront();
+
+    const size_t k = (head_ + size_) & mask_;
+    x_[k] = pt.x;
+    y_[k] = pt.y;
+    t_[k] = ToUs(t);
+    ++size_;
+}
+
+void TrailBuffer::PopFront(size_t n) noexcept
+{
+    n = std::min(n, size_);
+    head_ = (head_ + n) & mask_;
+    size_ -= n;
+}
+
+void TrailBuffer::ExpireOlderThan(TrailClock::time_point now, float maxAgeMs) noexcept
+{
+    if (size_ == 0)
+        return;
+    Rebase(now);
+
+    // age_ms > maxAgeMs with truncated ms  <=>  age_us >= (floor(maxAgeMs) + 1) * 1000
+    const int64_t limitUs = (static_cast<int64_t>(std::floor(maxAgeMs)) + 1) * 1000;
+    const int64_t cutoff64 = static_cast<int64_t>(ToUs(now)) - limitUs;
+    if (cutoff64 < INT32_MIN)
+        return;
+    const int32_t cutoff = static_cast<int32_t>(cutoff64);
+    if (t_[head_] > cutoff)
+        return; // Common case: nothing to drop
+
+    // Timestamps are monotonic, so expired samples form a prefix of the runs
+    Run runs[2];
+    const size_t nRuns = Runs(runs);
+    size_t expired = 0;
+    for (size_t r = 0; r < nRuns; ++r)
+    {
+        const int32_t* t = runs[r].t;
+        const size_t n = static_cast<size_t>(
+            std::partition_point(t, t + runs[r].count, [cutoff](int32_t v) { return v <= cutoff; }) - t);
+        expired += n;
+        if (n < runs[r].count)
+            break;
+    }
+
+    PopFront(expired);
+}
+
+size_t TrailBuffer::Runs(Run out[2]) const noexcept
+{
+    if (size_ == 0)
+        return 0;
+
+    const size_t first = std::min(size_, Capacity() - head_);
+    out[0] = { x_.get() + head_, y_.get() + head_, t_.get() + head_, first };
+    if (first == size_)
+        return 1;
+
+    out[1] = { x_.get(), y_.get(), t_.get(), size_ - first };
+    return 2;
+}
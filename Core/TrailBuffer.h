@@ -0,0 +1,77 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+using TrailClock = std::chrono::steady_clock;
+
+// Screen-space position in pixels
+struct TrailPoint final
+{
+    int x = 0, y = 0;
+};
+
+// Fixed-capacity ring of trail samples stored as separate x, y and timestamp arrays.
+// Timestamps are integer microseconds relative to an epoch that is moved forward
+// as time passes, so they fit 32 bits. Nothing allocates after construction.
+class TrailBuffer final
+{
+public:
+    // Contiguous slice of the ring; a full traversal is at most two of these
+    struct Run final
+    {
+        const int32_t* x = nullptr;
+        const int32_t* y = nullptr;
+        const int32_t* t = nullptr;
+        size_t count = 0;
+    };
+
+    explicit TrailBuffer(size_t maxSamples = 500);
+
+    [[nodiscard]] size_t Size() const noexcept { return size_; }
+    [[nodiscard]] bool Empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] size_t MaxSize() const noexcept { return maxSize_; }
+    [[nodiscard]] size_t Capacity() const noexcept { return mask_ + 1; }
+
+    void Clear() noexcept { head_ = size_ = 0; }
+
+    // Appends a sample, dropping the oldest one when MaxSize() is reached
+    void Push(TrailPoint pt, TrailClock::time_point t) noexcept;
+
+    // Drops the n oldest samples
+    void PopFront(size_t n = 1) noexcept;
+
+    // Drops leading samples whose whole-millisecond age at now exceeds maxAgeMs
+    void ExpireOlderThan(TrailClock::time_point now, float maxAgeMs) noexcept;
+
+    // Oldest-first accessors
+    [[nodiscard]] TrailPoint Point(size_t i) const noexcept
+    {
+        const size_t k = (head_ + i) & mask_;
+        return { x_[k], y_[k] };
+    }
+    [[nodiscard]] int32_t TimeUs(size_t i) const noexcept { return t_[(head_ + i) & mask_]; }
+    [[nodiscard]] TrailClock::time_point TimePoint(size_t i) const noexcept
+    {
+        return epoch_ + std::chrono::microseconds(TimeUs(i));
+    }
+    [[nodiscard]] TrailPoint Back() const noexcept { return Point(size_ - 1); }
+
+    // Time relative to the epoch in microseconds, saturated to 32 bits
+    [[nodiscard]] int32_t ToUs(TrailClock::time_point t) const noexcept;
+
+    // Splits the live samples into oldest-first contiguous runs, returns the run count
+    size_t Runs(Run out[2]) const noexcept;
+
+private:
+    // Moves the epoch forward when now drifts too far from it
+    void Rebase(TrailClock::time_point now) noexcept;
+
+    std::unique_ptr<int32_t[]> x_, y_, t_;
+    size_t mask_ = 0;
+    size_t head_ = 0, size_ = 0;
+    size_t maxSize_ = 0;
+    TrailClock::time_point epoch_{};
+    bool hasEpoch_ = false;
+};
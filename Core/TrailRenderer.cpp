@@ -0,0 +1,479 @@
+#include "Core/TrailRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CURSORBLUR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// exp(-x) and (1 - exp(-x)) / x sampled for x in [0, kExpRange] as interleaved pairs, read at
+// the nearest entry; beyond that coverage is opaque. The step keeps keep * 255 within half a level
+constexpr int kExpTableSize = 4096;
+constexpr float kExpRange = 16.f;
+
+struct ExpTables final
+{
+    float keepGain[(kExpTableSize + 1) * 2];
+
+    // Weight -ln(1 - a) of a stamp with alpha a, so summed weights resolve to the coverage of
+    // sequential blending for opaque texels; a full-alpha stamp counts as 254
+    float stampWeight[256];
+
+    ExpTables() noexcept
+    {
+        for (int i = 0; i <= kExpTableSize; ++i)
+        {
+            const float x = kExpRange * static_cast<float>(i) / kExpTableSize;
+            keepGain[i * 2] = std::exp(-x);
+            keepGain[i * 2 + 1] = x > 0.f ? (1.f - keepGain[i * 2]) / x : 1.f;
+        }
+        for (int a = 0; a < 256; ++a)
+            stampWeight[a] = -std::log(1.f - static_cast<float>(std::min(a, 254)) / 255.f);
+    }
+};
+
+static const ExpTables sExp;
+
+TrailRenderStats TrailRenderer::Render(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+    int originX, int originY, TrailClock::time_point now, const TrailSettings& settings)
+{
+    lut_.Update(settings);
+    switch (settings.method)
+    {
+        case RenderMethod::Swept:
+            // Prefix sums cover one image; animated cursors are stamped frame by frame
+            if (sprite.Animated())
+                return RenderStamped(dst, sprite, trail, originX, originY, now, settings);
+            return RenderSwept(dst, sprite, trail, originX, originY, now, settings);
+        case RenderMethod::Subpixel:
+            return RenderSubpixel(dst, sprite, trail, originX, originY, now, settings);
+        case RenderMethod::Stamp:
+        default:
+            return RenderStamped(dst, sprite, trail, originX, originY, now, settings);
+    }
+}
+
+TrailRenderStats TrailRenderer::RenderStamped(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+    int originX, int originY, TrailClock::time_point now, const TrailSettings& settings)
+{
+    if (pool_)
+        return tiles_.Render(dst, sprite, trail, originX, originY, now, settings, *pool_);
+    return RenderTrail(dst, sprite, trail, originX, originY, now, settings, lut_);
+}
+
+TrailRenderStats TrailRenderer::RenderSubpixel(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+    int originX, int originY, TrailClock::time_point now, const TrailSettings& settings)
+{
+    TrailRenderStats stats;
+    if (dst.Empty() || sprite.Empty())
+        return stats;
+
+    if (phases_.empty() || sprite.w != phaseW_ || sprite.h != phaseH_ || sprite.px != phaseSrc_ ||
+        phases_[0].frameEndUs != sprite.frameEndUs || phases_[0].hotX != sprite.hotX || phases_[0].hotY != sprite.hotY)
+    {
+        BuildPhaseSprites(sprite, phases_);
+        phaseSrc_ = sprite.px;
+        phaseW_ = sprite.w;
+        phaseH_ = sprite.h;
+    }
+
+    // One stamp stands in for spacing one-pixel stamps: 1 - (1 - a)^spacing keeps the coverage
+    const float spacing = std::clamp(settings.stampSpacing, 1.f / kSubpixelGrid, 8.f);
+    if (spacing != spacedFor_)
+    {
+        for (int a = 0; a < 256; ++a)
+            spacedAlpha_[a] = static_cast<uint8_t>(std::lround(255.f * (1.f - std::pow(1.f - a / 255.f, spacing))));
+        spacedFor_ = spacing;
+    }
+
+    const int32_t nowUs = trail.ToUs(now);
+    const bool animated = sprite.Animated() && !trail.Empty();
+    const int64_t epochUs = animated ? std::chrono::duration_cast<std::chrono::microseconds>(
+        trail.TimePoint(0).time_since_epoch()).count() - trail.TimeUs(0) : 0;
+    const int hotXq = sprite.hotX * kSubpixelGrid, hotYq = sprite.hotY * kSubpixelGrid;
+
+    // Same segment order as the stamping renderer, which starts at the newest sample, so a
+    // stamp always lands on the cursor; the distance to the next stamp carries across samples
+    float offset = 0.f;
+    for (int i = static_cast<int>(trail.Size()) - 2; i >= 0; --i)
+    {
+        const int64_t age0 = (static_cast<int64_t>(nowUs) - trail.TimeUs(i)) / 1000;
+        if (static_cast<float>(age0) > settings.fadeMs)
+            continue;
+
+        const int64_t t0 = epochUs + trail.TimeUs(i);
+        const int64_t dt = static_cast<int64_t>(trail.TimeUs(i + 1)) - trail.TimeUs(i);
+        offset = StepSegmentSubpixel(trail.Point(i), trail.Point(i + 1), static_cast<int>(age0), lut_, spacing, offset,
+            [&](int xq, int yq, uint8_t a, float t)
+        {
+            const uint8_t alpha = spacedAlpha_[a];
+            if (alpha < 3)
+                return;
+
+            // Whole pixel by floor division, the remainder picks the phase
+            const int qx = xq - hotXq, qy = yq - hotYq;
+            const int fx = (qx % kSubpixelGrid + kSubpixelGrid) % kSubpixelGrid;
+            const int fy = (qy % kSubpixelGrid + kSubpixelGrid) % kSubpixelGrid;
+            const Sprite& phase = phases_[static_cast<size_t>(fy) * kSubpixelGrid + fx];
+            const int dstX = (qx - fx) / kSubpixelGrid - originX;
+            const int dstY = (qy - fy) / kSubpixelGrid - originY;
+            const int frame = animated ? sprite.FrameAt(t0 + static_cast<int64_t>(static_cast<float>(dt) * t)) : 0;
+            const uint64_t blended = BlendSprite(dst, phase, dstX, dstY, alpha, frame);
+            if (blended)
+                stats.bounds = RectUnion(stats.bounds, SpriteRect(dst, phase, dstX, dstY));
+            stats.pixelsBlended += blended;
+            ++stats.stamps;
+        });
+    }
+
+    return stats;
+}
+
+// Sheared cursor texels along the minor axis are sampled at this fraction of a pixel
+constexpr int kShearPhases = 4;
+
+// Integrating one destination pixel costs about this many blended stamp pixels: two prefix sum
+// rows and a float resolve against a vector integer blend, plus a share of the shear table
+constexpr int kSweptPixelCost = 10;
+
+// Repeated source-over of many faint stamps compounds coverage as 1 - prod(1 - a_j),
+// which tends to 1 - exp(-sum a_j); the accumulated color is scaled by the same factor
+// so uniform stamps match sequential blending. An empty sum leaves d unchanged.
+#if defined(CURSORBLUR_SSE2)
+static inline void ResolvePixel(uint32_t& d, __m128 p) noexcept
+{
+    const float a = _mm_cvtss_f32(_mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3)));
+    if (!(a > 0.f))
+        return;
+    constexpr float kIndexScale = kExpTableSize / (kExpRange * 255.f);
+    const int i = static_cast<int>(std::min(a * kIndexScale + 0.5f, static_cast<float>(kExpTableSize)));
+
+    // One pixel per register: 4 channels of acc * gain + dst * keep, saturated by the packs
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i di = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(d)), zero), zero);
+    const __m128 v = _mm_add_ps(_mm_mul_ps(p, _mm_set1_ps(sExp.keepGain[i * 2 + 1])),
+        _mm_mul_ps(_mm_cvtepi32_ps(di), _mm_set1_ps(sExp.keepGain[i * 2])));
+    const __m128i vi = _mm_cvtps_epi32(v);
+    d = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(vi, vi), zero)));
+}
+#else
+static inline void ResolvePixel(uint32_t& d, const float* p) noexcept
+{
+    if (!(p[3] > 0.f))
+        return;
+    constexpr float kIndexScale = kExpTableSize / (kExpRange * 255.f);
+    const int i = static_cast<int>(std::min(p[3] * kIndexScale + 0.5f, static_cast<float>(kExpTableSize)));
+    const float keep = sExp.keepGain[i * 2];
+    const float gain = sExp.keepGain[i * 2 + 1];
+
+    const uint32_t dc = d;
+    uint32_t out = 0;
+    for (int c = 0; c < 4; ++c)
+    {
+        const float v = std::min(std::max(p[c] * gain + static_cast<float>((dc >> (c * 8)) & 0xFF) * keep, 0.f), 255.f);
+        out |= static_cast<uint32_t>(v + 0.5f) << (c * 8);
+    }
+    d = out;
+}
+#endif
+
+// Round to nearest for the small magnitudes of shear offsets, without a library call
+static inline int RoundOffset(float v) noexcept
+{
+    constexpr float kBias = 65536.f;
+    return static_cast<int>(v + (kBias + 0.5f)) - static_cast<int>(kBias);
+}
+
+// For every minor offset c that reaches into the cursor, prefix sums along the major axis u of
+// T(u) = S(u, c + u * slope), the cursor sheared to the slope and sampled linearly across
+// rows, and of u * T(u). Flicks keep one direction for many segments, so the table is kept
+// while the slope and the cursor are unchanged.
+void TrailRenderer::BuildShearTable(const Sprite& sprite, bool vertical, float slope)
+{
+    const bool sameSprite = sprite.w == shearW_ && sprite.h == shearH_ && sprite.px == shearSrc_;
+    if (shearValid_ && sameSprite && vertical == shearVertical_ && slope == shearSlope_)
+        return;
+
+    const int majorLen = vertical ? sprite.h : sprite.w;
+    const int minorLen = vertical ? sprite.w : sprite.h;
+
+    // Cursor as float texels by minor line, major axis contiguous, with majorLen clear lines on
+    // either side: slopes are at most 1, so every sampled line is in the array
+    const int pad = majorLen;
+    if (!shearValid_ || !sameSprite || vertical != shearVertical_)
+    {
+        shearW_ = sprite.w;
+        shearH_ = sprite.h;
+        shearSrc_ = sprite.px;
+        shearTexels_.assign(static_cast<size_t>(minorLen + 2 * pad) * majorLen * 4, 0.f);
+        for (int v = 0; v < minorLen; ++v)
+        {
+            for (int u = 0; u < majorLen; ++u)
+            {
+                const uint32_t p = vertical ? sprite.px[static_cast<size_t>(u) * sprite.w + v] : sprite.px[static_cast<size_t>(v) * sprite.w + u];
+                float* t = shearTexels_.data() + (static_cast<size_t>(v + pad) * majorLen + u) * 4;
+                for (int ch = 0; ch < 4; ++ch)
+                    t[ch] = static_cast<float>((p >> (ch * 8)) & 0xFF);
+            }
+        }
+    }
+    shearValid_ = true;
+    shearVertical_ = vertical;
+    shearSlope_ = slope;
+
+    // Offsets with any sampled texel inside the cursor: -1 < c + u * slope < minorLen
+    const float reach = static_cast<float>(majorLen - 1) * slope;
+    shearQLo_ = static_cast<int>(std::floor((-1.f - std::max(0.f, reach)) * kShearPhases)) + 1;
+    const int qHi = static_cast<int>(std::ceil((static_cast<float>(minorLen) - std::min(0.f, reach)) * kShearPhases)) - 1;
+    shearRows_ = qHi - shearQLo_ + 1;
+
+    const size_t stride = static_cast<size_t>(majorLen + 1) * 4;
+    const size_t line = static_cast<size_t>(majorLen) * 4;
+    shearP0_.resize(static_cast<size_t>(shearRows_) * stride);
+    shearP1_.resize(shearP0_.size());
+    for (int row = 0; row < shearRows_; ++row)
+    {
+        float* p0 = shearP0_.data() + static_cast<size_t>(row) * stride;
+        float* p1 = shearP1_.data() + static_cast<size_t>(row) * stride;
+
+        // Line coordinate biased by the padding so it stays positive and truncates as floor
+        float v = static_cast<float>(shearQLo_ + row) / kShearPhases + static_cast<float>(pad);
+#if defined(CURSORBLUR_SSE2)
+        __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+        _mm_storeu_ps(p0, acc0);
+        _mm_storeu_ps(p1, acc1);
+#else
+        float acc0[4] = {}, acc1[4] = {};
+        for (int ch = 0; ch < 4; ++ch)
+            p0[ch] = p1[ch] = 0.f;
+#endif
+        for (int u = 0; u < majorLen; ++u, v += slope)
+        {
+            const int v0 = static_cast<int>(v);
+            const float f = v - static_cast<float>(v0);
+            const float* lo = shearTexels_.data() + static_cast<size_t>(v0) * line + static_cast<size_t>(u) * 4;
+            const float* hi = lo + line;
+            const float fu = static_cast<float>(u);
+#if defined(CURSORBLUR_SSE2)
+            const __m128 l = _mm_loadu_ps(lo);
+            const __m128 t = _mm_add_ps(l, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(hi), l), _mm_set1_ps(f)));
+            acc0 = _mm_add_ps(acc0, t);
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(t, _mm_set1_ps(fu)));
+            _mm_storeu_ps(p0 + (u + 1) * 4, acc0);
+            _mm_storeu_ps(p1 + (u + 1) * 4, acc1);
+#else
+            for (int ch = 0; ch < 4; ++ch)
+            {
+                const float t = lo[ch] + (hi[ch] - lo[ch]) * f;
+                p0[(u + 1) * 4 + ch] = acc0[ch] += t;
+                p1[(u + 1) * 4 + ch] = acc1[ch] += t * fu;
+            }
+#endif
+        }
+    }
+}
+
+// Destination pixel (j, i) relative to the segment's first cursor corner sees cursor texels
+// u in [j - len, j] of the line at offset c = i - j * slope, with weight w(j - u), so
+//   sum = (w0 + dw * j) * (P0[hi] - P0[lo]) - dw * (P1[hi] - P1[lo])
+// Each destination pixel is computed once, so it is resolved straight into dst. Rows are
+// walked in destination order whichever axis is major.
+void TrailRenderer::SweepSegment(const SurfaceView& dst, const SweptSegment& seg, const Sprite& sprite,
+    TrailRenderStats& stats) noexcept
+{
+    const int majorLen = seg.vertical ? sprite.h : sprite.w;
+    const int dstMajor = seg.vertical ? dst.h : dst.w;
+    const int dstMinor = seg.vertical ? dst.w : dst.h;
+    const size_t stride = static_cast<size_t>(majorLen + 1) * 4;
+    const int spanMajor = seg.len + majorLen;
+
+    // Offsets covered by the table, as a half-open range of c
+    const float cLo = (static_cast<float>(shearQLo_) - 0.5f) / kShearPhases;
+    const float cHi = (static_cast<float>(shearQLo_ + shearRows_) - 0.5f) / kShearPhases;
+
+    const auto blendAt = [&](int j, int q, uint32_t* d)
+    {
+        const int lo = std::max(0, j - seg.len) * 4;
+        const int hi = (std::min(majorLen - 1, j) + 1) * 4;
+        const float* p0 = shearP0_.data() + static_cast<size_t>(q) * stride;
+        const float* p1 = shearP1_.data() + static_cast<size_t>(q) * stride;
+        const float base = seg.w0 + seg.dw * static_cast<float>(j);
+#if defined(CURSORBLUR_SSE2)
+        const __m128 s0 = _mm_sub_ps(_mm_loadu_ps(p0 + hi), _mm_loadu_ps(p0 + lo));
+        const __m128 s1 = _mm_sub_ps(_mm_loadu_ps(p1 + hi), _mm_loadu_ps(p1 + lo));
+        ResolvePixel(*d, _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(base), s0), _mm_mul_ps(_mm_set1_ps(seg.dw), s1)));
+#else
+        float sum[4];
+        for (int c = 0; c < 4; ++c)
+            sum[c] = base * (p0[hi + c] - p0[lo + c]) - seg.dw * (p1[hi + c] - p1[lo + c]);
+        ResolvePixel(*d, sum);
+#endif
+    };
+
+    PixelRect touched{ dst.w, dst.h, 0, 0 };
+    uint64_t count = 0;
+    const auto addRun = [&](int x0, int y0, int x1, int y1, int n)
+    {
+        touched = RectUnion(touched, { x0, y0, x1, y1 });
+        count += static_cast<uint64_t>(n);
+    };
+
+    const int jFrom = std::max(0, -seg.major0);
+    const int jTo = std::min(spanMajor, dstMajor - seg.major0);
+    const int iClipFrom = -seg.minor0;
+    const int iClipTo = dstMinor - seg.minor0;
+    if (seg.vertical)
+    {
+        // Major axis is y: one destination row per j, the offsets in range form a run of x
+        // whose table line advances kShearPhases per pixel
+        for (int j = jFrom; j < jTo; ++j)
+        {
+            const float shift = static_cast<float>(j) * seg.slope;
+            const int iFrom = std::max(iClipFrom, static_cast<int>(std::ceil(cLo + shift)));
+            const int iTo = std::min(iClipTo, static_cast<int>(std::ceil(cHi + shift)));
+            if (iFrom >= iTo)
+                continue;
+            uint32_t* row = dst.Row(seg.major0 + j) + seg.minor0;
+            int q = RoundOffset((static_cast<float>(iFrom) - shift) * kShearPhases) - shearQLo_;
+            int n = 0, first = iTo, last = iFrom;
+            for (int i = iFrom; i < iTo; ++i, q += kShearPhases)
+            {
+                if (q < 0 || q >= shearRows_)
+                    continue;
+                blendAt(j, q, row + i);
+                first = std::min(first, i);
+                last = i;
+                ++n;
+            }
+            if (n)
+                addRun(seg.minor0 + first, seg.major0 + j, seg.minor0 + last + 1, seg.major0 + j + 1, n);
+        }
+    }
+    else
+    {
+        // Major axis is x: one destination row per i, with the run of j whose offsets are in range
+        const float reach = static_cast<float>(spanMajor - 1) * seg.slope;
+        const int iFrom = std::max(iClipFrom, static_cast<int>(std::ceil(cLo + std::min(0.f, reach))));
+        const int iTo = std::min(iClipTo, static_cast<int>(std::ceil(cHi + std::max(0.f, reach))));
+        for (int i = iFrom; i < iTo; ++i)
+        {
+            int rowFrom = jFrom, rowTo = jTo;
+            if (seg.slope != 0.f)
+            {
+                // i - j * slope in [cLo, cHi), widened by a pixel; lines outside the table are skipped
+                const float a = (static_cast<float>(i) - cHi) / seg.slope;
+                const float b = (static_cast<float>(i) - cLo) / seg.slope;
+                rowFrom = std::max(rowFrom, static_cast<int>(std::floor(std::min(a, b))) - 1);
+                rowTo = std::min(rowTo, static_cast<int>(std::ceil(std::max(a, b))) + 2);
+            }
+            uint32_t* row = dst.Row(seg.minor0 + i) + seg.major0;
+            const float ci = static_cast<float>(i) * kShearPhases;
+            const float cStep = seg.slope * kShearPhases;
+            int n = 0, first = rowTo, last = rowFrom;
+            for (int j = rowFrom; j < rowTo; ++j)
+            {
+                const int q = RoundOffset(ci - static_cast<float>(j) * cStep) - shearQLo_;
+                if (q < 0 || q >= shearRows_)
+                    continue;
+                blendAt(j, q, row + j);
+                first = std::min(first, j);
+                last = j;
+                ++n;
+            }
+            if (n)
+                addRun(seg.major0 + first, seg.minor0 + i, seg.major0 + last + 1, seg.minor0 + i + 1, n);
+        }
+    }
+
+    if (count)
+    {
+        stats.pixelsBlended += count;
+        stats.bounds = RectUnion(stats.bounds, touched);
+    }
+}
+
+TrailRenderStats TrailRenderer::RenderSwept(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+    int originX, int originY, TrailClock::time_point now, const TrailSettings& settings)
+{
+    TrailRenderStats stats;
+    if (dst.Empty() || sprite.Empty())
+        return stats;
+
+    const int32_t nowUs = trail.ToUs(now);
+    for (int i = static_cast<int>(trail.Size()) - 2; i >= 0; --i)
+    {
+        const TrailPoint p0 = trail.Point(i);
+        const TrailPoint p1 = trail.Point(i + 1);
+
+        const int64_t age0 = (static_cast<int64_t>(nowUs) - trail.TimeUs(i)) / 1000;
+        if (static_cast<float>(age0) > settings.fadeMs)
+            continue;
+
+        const int dx = p1.x - p0.x;
+        const int dy = p1.y - p0.y;
+        if (dx * dx + dy * dy < 1)
+            continue;
+
+        // Same stamps, alphas and order as the stamping renderer
+        segStamps_.clear();
+        float wSum = 0.f;
+        StepSegment(p0, p1, static_cast<int>(age0), lut_, [&](int px, int py, uint8_t a)
+        {
+            if (a < 3)
+                return;
+            segStamps_.push_back({ px, py, a });
+            wSum += sExp.stampWeight[a];
+        });
+        if (segStamps_.empty())
+            continue;
+        stats.stamps += static_cast<int>(segStamps_.size());
+
+        SweptSegment seg;
+        seg.vertical = std::abs(dy) > std::abs(dx);
+        const int majorLen = seg.vertical ? sprite.h : sprite.w;
+        const int minorLen = seg.vertical ? sprite.w : sprite.h;
+        const int dMajor = seg.vertical ? dy : dx;
+        const int dMinor = seg.vertical ? dx : dy;
+        seg.len = std::abs(dMajor);
+        seg.slope = static_cast<float>(dMinor) / static_cast<float>(dMajor);
+
+        // Integrating touches the swept area once; stamping touches every cursor pixel per stamp
+        const int bandH = static_cast<int>(std::ceil(minorLen + std::abs(seg.slope) * static_cast<float>(majorLen - 1))) + 1;
+        const uint64_t stampCost = static_cast<uint64_t>(segStamps_.size()) * sprite.w * sprite.h;
+        const uint64_t sweptCost = static_cast<uint64_t>(kSweptPixelCost) * (seg.len + majorLen) * bandH;
+        if (stampCost <= sweptCost)
+        {
+            for (const SegmentStamp& st : segStamps_)
+            {
+                const int x = st.x - originX - sprite.hotX;
+                const int y = st.y - originY - sprite.hotY;
+                const uint64_t blended = BlendSprite(dst, sprite, x, y, st.alpha);
+                if (blended)
+                    stats.bounds = RectUnion(stats.bounds, SpriteRect(dst, sprite, x, y));
+                stats.pixelsBlended += blended;
+            }
+            continue;
+        }
+
+        // From the low end of the major axis; stamps run from p1 to p0
+        const bool fromP0 = dMajor > 0;
+        const TrailPoint low = fromP0 ? p0 : p1;
+        const float wLow = sExp.stampWeight[(fromP0 ? segStamps_.back() : segStamps_.front()).alpha];
+        const float wHigh = sExp.stampWeight[(fromP0 ? segStamps_.front() : segStamps_.back()).alpha];
+        seg.major0 = seg.vertical ? low.y - originY - sprite.hotY : low.x - originX - sprite.hotX;
+        seg.minor0 = seg.vertical ? low.x - originX - sprite.hotX : low.y - originY - sprite.hotY;
+
+        // Linear weight profile across the len + 1 positions, scaled to the stamps' total weight
+        const float rawSum = static_cast<float>(seg.len + 1) * (wLow + wHigh) * 0.5f;
+        const float scale = rawSum > 0.f ? wSum / rawSum : 0.f;
+        seg.w0 = wLow * scale;
+        seg.dw = (wHigh - wLow) / static_cast<float>(seg.len) * scale;
+
+        BuildShearTable(sprite, seg.vertical, seg.slope);
+        SweepSegment(dst, seg, sprite, stats);
+    }
+
+    return stats;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <vector>
+#include "Core/Compositor.h"
+#include "Core/TrailStepper.h"
+#include "Core/TileCompositor.h"
+
+// Renders the trail with the method selected in TrailSettings, owning any
+// scratch memory the method needs so frames do not allocate in steady state
+class TrailRenderer final
+{
+public:
+    TrailRenderStats Render(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+        int originX, int originY, TrailClock::time_point now, const TrailSettings& settings);
+
+    // Stamps large frames in tiles across pool's threads; nullptr stamps on the calling thread.
+    // The pool must outlive the renderer or be unset first.
+    void SetPool(WorkStealingPool* pool) noexcept { pool_ = pool; }
+
+    [[nodiscard]] const TileCompositor& Tiles() const noexcept { return tiles_; }
+
+private:
+    // Stamp method, tiled when there is a pool
+    TrailRenderStats RenderStamped(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+        int originX, int originY, TrailClock::time_point now, const TrailSettings& settings);
+
+    // One segment of the path as a box filter along its motion vector: the cursor placed at every
+    // major-axis pixel k in [0, len] from the low end, offset by k * slope along the minor axis,
+    // with weight w(k) = w0 + dw * k
+    struct SweptSegment
+    {
+        int major0 = 0, minor0 = 0; // Destination position of the cursor's top-left corner at k = 0
+        int len = 0;
+        bool vertical = false;      // Major axis is y
+        float slope = 0.f;          // Minor-axis offset per major-axis pixel, |slope| <= 1
+        float w0 = 0.f, dw = 0.f;
+    };
+
+    // Swept method: integrates the cursor along each segment with prefix sums over the cursor
+    // sheared to the segment's slope, so cost follows the swept area rather than its length.
+    // Segments too short to pay for that are stamped.
+    TrailRenderStats RenderSwept(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+        int originX, int originY, TrailClock::time_point now, const TrailSettings& settings);
+
+    void BuildShearTable(const Sprite& sprite, bool vertical, float slope);
+    void SweepSegment(const SurfaceView& dst, const SweptSegment& seg, const Sprite& sprite, TrailRenderStats& stats) noexcept;
+
+    // Subpixel method: blends phase copies of the cursor at quarter-pixel positions, with each
+    // stamp's alpha raised to cover the travel of stampSpacing one-pixel stamps
+    TrailRenderStats RenderSubpixel(const SurfaceView& dst, const Sprite& sprite, const TrailBuffer& trail,
+        int originX, int originY, TrailClock::time_point now, const TrailSettings& settings);
+
+    struct SegmentStamp
+    {
+        int x = 0, y = 0;
+        uint8_t alpha = 0;
+    };
+
+    TrailAlphaLut lut_;
+    WorkStealingPool* pool_ = nullptr;
+    TileCompositor tiles_;
+    std::vector<SegmentStamp> segStamps_;              // Stamps of the segment being rendered
+    PixelVector shearSrc_;                             // Sprite pixels the shear table was built from
+    int shearW_ = 0, shearH_ = 0;
+    bool shearVertical_ = false, shearValid_ = false;
+    float shearSlope_ = 0.f;
+    int shearQLo_ = 0, shearRows_ = 0;                 // Minor offsets c = (shearQLo_ + row) / kShearPhases
+    std::vector<float> shearTexels_;                   // Sprite as float texels along the sweep, padded with clear lines
+    std::vector<float> shearP0_, shearP1_;             // Per offset, prefix sums of T and u*T along the major axis, 4 channels
+    std::vector<Sprite> phases_;                       // Sprite shifted by each fraction of a pixel
+    PixelVector phaseSrc_;                             // Sprite pixels the phases were built from
+    int phaseW_ = 0, phaseH_ = 0;
+    uint8_t spacedAlpha_[256] = {};                    // 1 - (1 - a)^spacing for the spacing below
+    float spacedFor_ = 0.f;
+};
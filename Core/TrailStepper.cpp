@@ -0,0 +1,72 @@
+#include "Core/TrailStepper.h"
+#include <algorithm>
+#include <cmath>
+
+void TrailAlphaLut::Update(const TrailSettings& settings)
+{
+    if (settings.fadeMs == fadeMs_ && settings.sensitivity == sensitivity_ && settings.maxAlpha == maxAlpha_)
+        return;
+
+    fadeMs_ = settings.fadeMs;
+    sensitivity_ = settings.sensitivity;
+    maxAlpha_ = settings.maxAlpha;
+    ageScaleQ16_ = static_cast<int64_t>(std::llround(kAgeLevels * 65536.0 / std::max(fadeMs_, 1e-3f)));
+
+    table_.resize(static_cast<size_t>(kSpeedLevels + 1) * kRowSize);
+    for (int s = 0; s <= kSpeedLevels; ++s)
+    {
+        uint8_t* row = table_.data() + static_cast<size_t>(s) * kRowSize;
+        const float speed = static_cast<float>(s) / kSpeedLevels;
+        for (int k = 0; k <= kAgeLevels; ++k)
+        {
+            const float fade = 1.f - static_cast<float>(k) / kAgeLevels;
+            row[k] = static_cast<uint8_t>(std::clamp(maxAlpha_ * fade * speed, 0.f, 255.f));
+        }
+        row[kAgeLevels + 1] = 0;
+    }
+    ++builds_;
+}
+
+// -ln(1 - a / 255) per alpha; the last entry stands in for opaque
+struct WidenTable final
+{
+    float logKeep[256];
+
+    WidenTable() noexcept
+    {
+        for (int a = 0; a < 255; ++a)
+            logKeep[a] = -std::log(1.f - a / 255.f);
+        logKeep[255] = 1e6f;
+    }
+};
+
+static const WidenTable sWiden;
+
+uint8_t WidenAlpha(uint8_t a, float k) noexcept
+{
+    return static_cast<uint8_t>(std::lround(255.f * (1.f - std::exp(-k * sWiden.logKeep[a]))));
+}
+
+int AdaptiveSegmentSteps(TrailPoint p0, TrailPoint p1, int ageMs, const TrailAlphaLut& lut,
+    int maxStepPx, uint8_t errorBudget) noexcept
+{
+    const int full = SegmentSteps(p0, p1);
+    if (errorBudget == 0 || maxStepPx <= 1 || full <= 1)
+        return full;
+
+    // The stamp at p0 is the youngest and so the brightest of the segment
+    const int dx = p1.x - p0.x;
+    const int dy = p1.y - p0.y;
+    const float dist = std::sqrt(static_cast<float>(dx * dx + dy * dy));
+    const uint8_t a = TrailAlphaLut::Alpha(lut.SpeedRow(dist), lut.AgeLevelQ16(ageMs));
+    if (a >= errorBudget)
+        return full;
+
+    // Longest step k with 1 - (1 - a)^k <= budget
+    float step = static_cast<float>(maxStepPx);
+    if (a > 0 && errorBudget < 255)
+        step = std::min(step, sWiden.logKeep[errorBudget] / sWiden.logKeep[a]);
+    if (step <= 1.f)
+        return full;
+    return std::clamp(static_cast<int>(std::ceil(dist / step)), 1, full);
+}
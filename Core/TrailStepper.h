@@ -0,0 +1,212 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "Core/Trail.h"
+
+// Stamp alpha as a function of quantized age and speed:
+//   maxAlpha * max(0, 1 - age / fadeMs) * clamp(dist * sensitivity, 0, 1)
+// One row per speed level, one entry per age level, so the inner stamping loop does a
+// single byte load instead of float fade math. Rebuilt only when the inputs change.
+class TrailAlphaLut final
+{
+public:
+    static constexpr int kAgeLevels = 256;   // Across [0, fadeMs]; one past the end is transparent
+    static constexpr int kSpeedLevels = 256; // Across [0, 1] of the speed factor
+    static constexpr int kRowSize = kAgeLevels + 2;
+
+    // Rebuilds the table if fadeMs, sensitivity or maxAlpha changed since the last call
+    void Update(const TrailSettings& settings);
+
+    // Row for a segment of the given length in pixels
+    [[nodiscard]] const uint8_t* SpeedRow(float dist) const noexcept
+    {
+        const float f = dist * sensitivity_;
+        const int level = f >= 1.f ? kSpeedLevels : static_cast<int>(f * kSpeedLevels + 0.5f);
+        return table_.data() + static_cast<size_t>(level) * kRowSize;
+    }
+
+    // Age level of a whole-millisecond age, in 16.16 fixed point
+    [[nodiscard]] int64_t AgeLevelQ16(int ageMs) const noexcept { return static_cast<int64_t>(ageMs) * ageScaleQ16_; }
+
+    // Entry of a speed row at the nearest age level to a 16.16 one. Ages below zero, from
+    // samples stamped after now, read as fresh; ages past fadeMs read as transparent
+    [[nodiscard]] static uint8_t Alpha(const uint8_t* row, int64_t ageQ16) noexcept
+    {
+        const int64_t level = (ageQ16 + 0x8000) >> 16;
+        return row[std::clamp<int64_t>(level, 0, kAgeLevels + 1)];
+    }
+
+    [[nodiscard]] uint64_t Builds() const noexcept { return builds_; }
+
+private:
+    std::vector<uint8_t> table_;
+    float fadeMs_ = -1.f, sensitivity_ = -1.f;
+    int maxAlpha_ = -1;
+    int64_t ageScaleQ16_ = 0;
+    uint64_t builds_ = 0;
+};
+
+// lround(base + d * j / n) while j counts down by one per step, in integers only. The
+// magnitude is tracked as |d| * j / n + 1/2 = q + r / 2n, so each step can only borrow;
+// the borrow is branch-free because it follows the slope's fraction, which the branch
+// predictor cannot learn, and keeps the loop-carried chain to three operations.
+struct RoundedDda final
+{
+    int base = 0, q = 0, r = 0, step2 = 0, den2 = 0;
+    int neg = 0; // -1 when d < 0
+
+    void Init(int b, int d, int n) noexcept
+    {
+        base = b;
+        neg = d < 0 ? -1 : 0;
+        step2 = 2 * std::abs(d);
+        den2 = 2 * n;
+        q = std::abs(d); // Starting at j = n
+        r = n;
+    }
+
+    [[nodiscard]] int Value() const noexcept
+    {
+        // Rounding the magnitude half up rounds the signed value half up for d >= 0 and
+        // half down for d < 0; lround takes exact ties (r == 0) away from zero instead
+        const int v = base + ((q ^ neg) - neg);
+        if (r != 0)
+            return v;
+        return neg ? v + (v >= 0 ? 1 : 0) : v - (v <= 0 ? 1 : 0);
+    }
+
+    void Next() noexcept
+    {
+        r -= step2; // |d| <= n, so at most one borrow
+        const int borrow = r >> 31; // -1 when r < 0
+        r += den2 & borrow;
+        q += borrow;
+    }
+};
+
+// Positions StepSegment visits minus one: one per pixel of travel, rounded up
+[[nodiscard]] inline int SegmentSteps(TrailPoint p0, TrailPoint p1) noexcept
+{
+    const int dx = p1.x - p0.x;
+    const int dy = p1.y - p0.y;
+    return static_cast<int>(std::ceil(std::sqrt(static_cast<float>(dx * dx + dy * dy))));
+}
+
+// Adaptive steps stay within the cursor's smaller extent divided by this, so every pixel the
+// cursor passes over is still covered by several stamps and no gaps open between them
+constexpr int kStampsPerCursor = 4;
+
+// Steps for the segment p0 -> p1 under an error budget. One stamp per pixel of travel, as
+// SegmentSteps, unless the segment's brightest stamp is faint enough that one stamp can stand
+// in for a longer step: its alpha raised to cover that step, 1 - (1 - a)^step, stays within
+// errorBudget. The step never exceeds maxStepPx. A zero budget always returns SegmentSteps.
+[[nodiscard]] int AdaptiveSegmentSteps(TrailPoint p0, TrailPoint p1, int ageMs, const TrailAlphaLut& lut,
+    int maxStepPx, uint8_t errorBudget) noexcept;
+
+// Alpha of one stamp standing in for k one-pixel stamps of alpha a: 1 - (1 - a)^k, rounded
+[[nodiscard]] uint8_t WidenAlpha(uint8_t a, float k) noexcept;
+
+// Walks the segment p0 -> p1 one position per pixel of travel, from p1 back to p0 (the
+// stamping order), calling fn(x, y, alpha) for every position including faint ones.
+// ageMs is the whole-millisecond age of p0; the fade grows to 1.1x that at p1.
+template<typename Fn>
+inline void StepSegment(TrailPoint p0, TrailPoint p1, int ageMs, const TrailAlphaLut& lut, Fn&& fn)
+{
+    const int dx = p1.x - p0.x;
+    const int dy = p1.y - p0.y;
+    const int distSq = dx * dx + dy * dy;
+    if (distSq < 1)
+        return;
+
+    const float dist = std::sqrt(static_cast<float>(distSq));
+    const int steps = static_cast<int>(std::ceil(dist));
+    const uint8_t* row = lut.SpeedRow(dist);
+
+    RoundedDda ix, iy;
+    ix.Init(p0.x, dx, steps);
+    iy.Init(p0.y, dy, steps);
+
+    // Age level at t = j / steps is age0 * (1 + 0.1 t)
+    const int64_t age0 = lut.AgeLevelQ16(ageMs);
+    const int64_t ageStep = age0 / (10 * static_cast<int64_t>(steps));
+    int64_t age = age0 + age0 / 10;
+    for (int j = steps; j >= 0; --j)
+    {
+        fn(ix.Value(), iy.Value(), TrailAlphaLut::Alpha(row, age));
+        ix.Next();
+        iy.Next();
+        age -= ageStep;
+    }
+}
+
+// StepSegment in the given number of steps, from AdaptiveSegmentSteps. With fewer steps than
+// SegmentSteps, positions are still lround of the exact interpolant and each stamp's alpha is
+// widened to cover the dist / steps pixels it stands in for; otherwise this is StepSegment.
+// Alphas below 3, which the compositor never draws, are passed through unwidened so a tail too
+// faint to draw one pixel apart does not appear once its stamps are spread out.
+template<typename Fn>
+inline void StepSegmentIn(TrailPoint p0, TrailPoint p1, int ageMs, const TrailAlphaLut& lut, int steps, Fn&& fn)
+{
+    if (steps >= SegmentSteps(p0, p1))
+    {
+        StepSegment(p0, p1, ageMs, lut, fn);
+        return;
+    }
+
+    const int dx = p1.x - p0.x;
+    const int dy = p1.y - p0.y;
+    const float dist = std::sqrt(static_cast<float>(dx * dx + dy * dy));
+    const float k = dist / static_cast<float>(steps);
+    const uint8_t* row = lut.SpeedRow(dist);
+
+    // d * j / n rounded half away from zero
+    const auto roundDiv = [steps](int v)
+    {
+        const int m = (2 * std::abs(v) + steps) / (2 * steps);
+        return v < 0 ? -m : m;
+    };
+
+    const int64_t age0 = lut.AgeLevelQ16(ageMs);
+    const int64_t ageStep = age0 / (10 * static_cast<int64_t>(steps));
+    int64_t age = age0 + age0 / 10;
+    for (int j = steps; j >= 0; --j)
+    {
+        const uint8_t a = TrailAlphaLut::Alpha(row, age);
+        fn(p0.x + roundDiv(dx * j), p0.y + roundDiv(dy * j), a < 3 ? a : WidenAlpha(a, k));
+        age -= ageStep;
+    }
+}
+
+// Walks the segment p0 -> p1 from p1 back to p0 like StepSegment, but every spacing px of
+// travel and without rounding to whole pixels: fn(x, y, alpha, t) receives positions in
+// 1 / kSubpixelGrid px and t, running from 1 at p1 to 0 at p0. The first position is offset
+// px past p1; the return value is the offset of the next position beyond p0, so passing it
+// to the following segment keeps the spacing even across sample joints. Ages and alphas
+// follow StepSegment at the same point.
+template<typename Fn>
+inline float StepSegmentSubpixel(TrailPoint p0, TrailPoint p1, int ageMs, const TrailAlphaLut& lut,
+    float spacing, float offset, Fn&& fn)
+{
+    const int dx = p1.x - p0.x;
+    const int dy = p1.y - p0.y;
+    const int distSq = dx * dx + dy * dy;
+    if (distSq < 1)
+        return offset;
+
+    const float dist = std::sqrt(static_cast<float>(distSq));
+    const uint8_t* row = lut.SpeedRow(dist);
+    const int64_t age0 = lut.AgeLevelQ16(ageMs);
+    const float ageGrowth = static_cast<float>(age0) * 0.1f;
+    float u = offset;
+    for (; u <= dist + 0.01f; u += spacing)
+    {
+        const float t = std::max(0.f, 1.f - u / dist);
+        fn(static_cast<int>(std::lround((p0.x + dx * t) * kSubpixelGrid)),
+            static_cast<int>(std::lround((p0.y + dy * t) * kSubpixelGrid)),
+            TrailAlphaLut::Alpha(row, age0 + static_cast<int64_t>(ageGrowth * t)), t);
+    }
+    return u - dist;
+}
@@ -2,43 +2,107 @@
 #define NOMINMAX
 #include <windows.h>
 #include <dwmapi.h>
-#include <deque>
+#include <shellscalingapi.h>
 #include <chrono>
 #include <algorithm>
 #include <thread>
+#include <atomic>
+#include <future>
 #include <functional>
+#include <mutex>
+#include <cstring>
+#include <cmath>
+#include "Core/Trail.h"
+#include "Core/Compositor.h"
+#include "Core/TrailAccumulator.h"
+#include "Core/InputQueue.h"
+#include "Core/SpscQueue.h"
+#include "Core/SpriteCache.h"
+#include "Core/Stats.h"
+#include "Core/TraceFile.h"
+#include "Core/SurfacePool.h"
+#include "Core/MonitorLayout.h"
+#include "Core/FramePacer.h"
+#include "Core/Presenter.h"
+#include "DCompPresenter.h"
+
+// How the overlay window is sized
+enum class OverlayMode
+{
+    FullScreen, // One window per display, redrawn only while the trail touches it
+    Follow      // Window sized to the trail, moved every frame
+};
 
-// Constants
-constexpr int kMaxTrailSize = 500; // Max count of trail samples
+// How the render loop is woken for each frame
+enum class PacingMode
+{
+    Timer, // High-resolution timer at the cursor display's refresh rate
+    Vsync  // Composition clock, rendering just in time before the next composition
+};
 
-// Launch arguments
-static float gSensitivity = 0.03f; // Fade intensity relative to cursor speed
-static float gTrailFadeMs = 50.f;  // How long each sample takes to fade out
-static BYTE gTrailMaxAlpha = 10;  // Trail starting opacity
-static BYTE TintR = 255, TintG = 255, TintB = 255; // Optional tint applied to trail
-
-// Cache of current cursor bitmap
-static HCURSOR sLastCursor = nullptr;
-static int sLastW = 0, sLastH = 0;
-static HDC sTintDC = nullptr;
-static HBITMAP sTintBMP = nullptr;
-static HGDIOBJ sTintOld = nullptr;
-static void* sTintBits = nullptr;
-
-// Sample data
-struct Sample final
-{
-    POINT pt;
-    std::chrono::steady_clock::time_point t;
+// How trail frames reach the screen
+enum class PresenterMode
+{
+    Layered,    // CPU compositing into layered window surfaces
+    Composition // DirectComposition sprite visuals, moved and faded by the compositor
 };
 
+// Launch arguments
+static TrailSettings gSettings;
+static OverlayMode gOverlayMode = OverlayMode::FullScreen;
+static PacingMode gPacingMode = PacingMode::Timer;
+static PresenterMode gPresenterMode = PresenterMode::Layered;
+static int gCompositeThreads = 1;         // Threads stamping large trails in tiles, the render thread included
+static wchar_t gStatsPath[MAX_PATH] = {}; // JSON-lines stats output, empty when disabled
+static wchar_t gRecordPath[MAX_PATH] = {}; // Binary cursor trace output, empty when disabled
+
+// Tinted cursor bitmaps by shape, size, tint and DPI
+static SpriteCache sSpriteCache;
+
+// Window classes: the main overlay also handles display changes, the other displays' overlays only draw
+static const wchar_t* const kOverlayClass = L"CursorTrailOverlay_CustomCursor";
+static const wchar_t* const kMonitorClass = L"CursorTrailOverlay_Monitor";
+constexpr UINT kMsgSyncMonitors = WM_APP; // Posted to the main overlay to re-enumerate displays
+
 // Current cursor visual
 struct CursorVisual final
 {
     HCURSOR hCur = nullptr;
     int width = 0, height = 0, hotX = 0, hotY = 0;
+    int frames = 1;                  // Animation steps, 1 for static cursors
+    std::vector<int64_t> frameEndUs; // Cumulative end of each step within one cycle
 };
 
+constexpr int kMaxCursorFrames = 64; // Longer animations are truncated
+
+// Undocumented but long-stable user32 export (Wine implements it too) that reports an
+// animated cursor's step count and each step's display rate in jiffies (1/60 s)
+using GetCursorFrameInfoFn = HCURSOR(WINAPI*)(HCURSOR, DWORD, DWORD, DWORD*, DWORD*);
+
+// Fills the animation timing of cv.hCur; cursors stay static if the export is missing
+static void QueryCursorFrames(CursorVisual& cv)
+{
+    static const auto getFrameInfo = reinterpret_cast<GetCursorFrameInfoFn>(
+        GetProcAddress(GetModuleHandleW(L"user32.dll"), "GetCursorFrameInfo"));
+
+    cv.frames = 1;
+    cv.frameEndUs.clear();
+    DWORD rate = 0, steps = 0;
+    if (!getFrameInfo || !getFrameInfo(cv.hCur, 0, 0, &rate, &steps) || steps <= 1)
+        return;
+
+    const int count = static_cast<int>(std::min<DWORD>(steps, kMaxCursorFrames));
+    int64_t end = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        DWORD stepRate = rate, n = 0;
+        getFrameInfo(cv.hCur, 0, static_cast<DWORD>(i), &stepRate, &n);
+        end += static_cast<int64_t>(std::max<DWORD>(stepRate, 1)) * 1000000 / 60;
+        cv.frameEndUs.push_back(end);
+    }
+    cv.frames = count;
+}
+
 // Returns bounding rectangle of the entire desktop
 inline RECT GetVirtualScreenRect() noexcept
 {
@@ -101,9 +165,10 @@ struct Backbuffer final
         return true;
     }
 
-    void Clear() noexcept
+    // Portable view of the DIB pixels for the core compositor
+    [[nodiscard]] SurfaceView View() const noexcept
     {
-        PatBlt(memDC, 0, 0, w, h, BLACKNESS);
+        return { static_cast<uint32_t*>(bits), w, h, w };
     }
 };
 
@@ -148,6 +213,157 @@ struct TempIconSurf final
     }
 };
 
+// Accumulated wall time of one stage of the frame pipeline
+struct StageTiming final
+{
+    uint64_t count = 0;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+
+    void Add(double ms) noexcept
+    {
+        ++count;
+        totalMs += ms;
+        maxMs = std::max(maxMs, ms);
+    }
+
+    [[nodiscard]] double AvgMs() const noexcept { return count ? totalMs / static_cast<double>(count) : 0.0; }
+};
+
+// Feeds a stage duration to both the exit summary and the instrumentation layer
+static void AddStage(StageTiming& timing, StatStage stage, TrailClock::duration d) noexcept
+{
+    timing.Add(std::chrono::duration<double, std::milli>(d).count());
+    RecordStage(stage, d);
+}
+
+// Per-frame work counters for the instrumentation layer
+static void CountRenderStats(const TrailRenderStats& stats) noexcept
+{
+    AddCounter(StatCounter::Stamps, static_cast<uint64_t>(stats.stamps));
+    AddCounter(StatCounter::StampsGenerated, static_cast<uint64_t>(stats.stamps) + static_cast<uint64_t>(stats.stampsCoalesced));
+    AddCounter(StatCounter::PixelsBlended, stats.pixelsBlended);
+    AddCounter(StatCounter::PixelsDecayed, stats.pixelsDecayed);
+}
+
+// Render target for one frame in flight. The render thread fills one slot while the
+// present thread pushes the previous one to the compositor.
+struct FrameSlot final
+{
+    Backbuffer monitors[kMaxMonitors]; // Full-screen mode surfaces by display, allocated on first use
+    SurfacePool<Backbuffer> pool;      // Follow mode surfaces
+
+    void Release() noexcept
+    {
+        for (Backbuffer& bb : monitors)
+            bb.Release();
+        pool.Release();
+    }
+
+    [[nodiscard]] size_t Bytes() const noexcept
+    {
+        size_t bytes = pool.Bytes();
+        for (const Backbuffer& bb : monitors)
+            bytes += static_cast<size_t>(bb.w) * bb.h * 4;
+        return bytes;
+    }
+};
+
+constexpr int kFrameSlots = 2;
+
+// Frame handed from the render thread to the present thread
+struct PresentJob final
+{
+    HWND hwnd = nullptr;      // Overlay window to update
+    int slot = -1;            // Slot to hand back once presented, -1 if the job holds none. A frame
+                              // spanning displays queues one job each and only the last carries it.
+    HDC srcDC = nullptr;      // nullptr hides the window (follow mode with nothing drawn)
+    POINT ptWin{}, ptSrc{};
+    SIZE size{};
+    RECT dirty{};
+    bool useDirty = false;
+    bool show = false;        // Follow mode: window was hidden before this frame
+    TrailClock::time_point started{}; // Render thread woke for this frame
+    TrailClock::time_point input{};   // Newest input sample in the trail
+    TrailClock::time_point queued{};
+};
+
+// Full-screen mode state of one display, owned by the render thread
+struct MonitorOverlay final
+{
+    HWND hwnd = nullptr;
+    MonitorArea area;
+    DamageTracker damage{ kFrameSlots };
+    TrailAccumulator accumulator;     // With accumulate set; only slot 0 circulates
+    bool holdsContent = true;         // Window may still show trail pixels that need clearing
+};
+
+// Rendering resources owned by the overlay windows
+struct OverlayContext final
+{
+    HWND hwnd = nullptr;              // Main overlay: the follow window, or the first display's
+    HINSTANCE hInstance = nullptr;
+    HDC screenDC = nullptr;           // Render thread: surface allocation and cursor rasterization
+    HDC presentDC = nullptr;          // Present thread: UpdateLayeredWindowIndirect
+    FrameSlot slots[kFrameSlots];
+    TempIconSurf tmp;
+    TrailRenderer renderer;
+    MonitorLayout layout;             // Render thread's copy of the display layout
+    MonitorOverlay monitors[kMaxMonitors];
+    bool followVisible = false;       // Render thread's view of the follow window
+
+    // Composition mode: set up before the threads start, then used by the render thread only.
+    // The window spans the virtual screen and holds no surface of its own.
+    std::unique_ptr<SpriteVisualBackend> visualBackend;
+    std::unique_ptr<SpriteVisualPresenter> visuals;
+
+    // Display layout and its overlay windows as last published by the UI thread, which owns the
+    // windows; the render thread adopts them at its next frame
+    std::vector<HWND> monitorWindows; // UI thread only
+    std::mutex layoutLock;
+    MonitorLayout pendingLayout;
+    std::vector<HWND> pendingWindows;
+    std::atomic<bool> layoutChanged{ false };
+
+    // Render -> present handoff and the way back, one producer and one consumer each.
+    // The events wake whichever side is waiting on an empty queue.
+    SpscQueue<PresentJob, 64> presentQueue;
+    SpscQueue<int, 4> freeSlots;
+    HANDLE jobReady = nullptr;
+    HANDLE slotReady = nullptr;
+    std::atomic<bool> quit{ false };
+
+    // Render and wait are written by the render thread, queue and present by the present
+    // thread; both are read once the threads have exited
+    StageTiming render;               // Input drain, cursor refresh and compositing
+    StageTiming wait;                 // Render thread blocked on a free slot
+    StageTiming queue;                // Job waiting between render and present
+    StageTiming present;              // UpdateLayeredWindowIndirect
+    StageTiming latency;              // Newest input sample to its frame's present returning
+    size_t peakSurfaceBytes = 0;
+
+    // Wake to present of the last presented frame in nanoseconds, -1 once the render thread has
+    // taken it; sizes the just-in-time lead in vsync pacing
+    std::atomic<int64_t> frameCostNs{ -1 };
+
+    void Release() noexcept
+    {
+        for (FrameSlot& slot : slots)
+            slot.Release();
+        tmp.Release();
+        visuals.reset();
+        visualBackend.reset();
+    }
+
+    [[nodiscard]] size_t SurfaceBytes() const noexcept
+    {
+        size_t bytes = 0;
+        for (const FrameSlot& slot : slots)
+            bytes += slot.Bytes();
+        return bytes;
+    }
+};
+
 // Updates cursor visual data when system cursor changes
 inline void RefreshCursorVisual(CursorVisual& cv, CURSORINFO ci) noexcept
 {
@@ -177,192 +393,1005 @@ inline void RefreshCursorVisual(CursorVisual& cv, CURSORINFO ci) noexcept
         if (ii.hbmColor)
             DeleteObject(ii.hbmColor);
     }
+    QueryCursorFrames(cv);
+}
+
+static inline void ReleaseTintCache()
+{
+    sSpriteCache.Clear();
+}
+
+// Looks the cursor up in the sprite cache at the given display DPI, rasterizing it through GDI
+// only on a miss. Cursor bitmaps come at the system DPI and the system scales the pointer to the
+// display it is on, so the trail is scaled the same way. Returns nullptr if allocation failed.
+[[nodiscard]] static const Sprite* TintSprite(HDC screenDC, TempIconSurf& tmp, const CursorVisual& cv, int dpi) noexcept
+{
+    static const int systemDpi = static_cast<int>(GetDpiForSystem());
+
+    SpriteKey key;
+    key.cursor = reinterpret_cast<uintptr_t>(cv.hCur);
+    key.w = ScaleForDpi(cv.width, dpi, systemDpi);
+    key.h = ScaleForDpi(cv.height, dpi, systemDpi);
+    key.tint = PackTint(gSettings.tintR, gSettings.tintG, gSettings.tintB);
+    key.dpi = dpi;
+
+    // The current shape sits at the front of the cache, so the usual frame finds it first
+    if (const Sprite* sprite = sSpriteCache.Find(key))
+    {
+        AddCounter(StatCounter::SpriteHits);
+        return sprite;
+    }
+
+    ScopedStageTimer timer(StatStage::Tint);
+    AddCounter(StatCounter::SpriteMisses);
+    if (!tmp.EnsureSize(screenDC, key.w, key.h * cv.frames))
+        return nullptr;
+
+    // Draw every animation step once, stacked into one atlas; the cache tints and keeps the pixels
+    PatBlt(tmp.memDC, 0, 0, tmp.w, tmp.h, BLACKNESS);
+    for (int f = 0; f < cv.frames; ++f)
+        DrawIconEx(tmp.memDC, 0, f * key.h, cv.hCur, key.w, key.h, static_cast<UINT>(f), nullptr, DI_NORMAL);
+    GdiFlush();
+
+    const Sprite& sprite = sSpriteCache.Insert(key, static_cast<const uint32_t*>(tmp.bits), tmp.w,
+        ScaleForDpi(cv.hotX, dpi, systemDpi), ScaleForDpi(cv.hotY, dpi, systemDpi), cv.frames, cv.frameEndUs);
+    SetGauge(StatGauge::SpriteCacheBytes, static_cast<int64_t>(sSpriteCache.Bytes()));
+    return &sprite;
+}
+
+// Calls UpdateLayeredWindowIndirect and records how long the compositor took
+static void Present(OverlayContext& ctx, const PresentJob& job) noexcept
+{
+    const BLENDFUNCTION bfW{ AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
+    POINT ptWin = job.ptWin;
+    POINT ptSrc = job.ptSrc;
+    SIZE size = job.size;
+    UPDATELAYEREDWINDOWINFO ulw{ sizeof(ulw) };
+    ulw.hdcDst = ctx.presentDC;
+    ulw.pptDst = &ptWin;
+    ulw.psize = &size;
+    ulw.hdcSrc = job.srcDC;
+    ulw.pptSrc = &ptSrc;
+    ulw.pblend = &bfW;
+    ulw.dwFlags = ULW_ALPHA;
+    ulw.prcDirty = job.useDirty ? &job.dirty : nullptr;
+
+    const auto t0 = TrailClock::now();
+    UpdateLayeredWindowIndirect(job.hwnd, &ulw);
+    AddStage(ctx.present, StatStage::Present, TrailClock::now() - t0);
+    AddCounter(StatCounter::Presents);
 }
 
-inline void UpdateTrail(std::deque<Sample>& trail, const POINT& ptNow,
-    std::chrono::steady_clock::time_point now) noexcept
+// Full-screen mode: redraw the damaged part of one display's surface
+static bool DrawTrailMonitor(OverlayContext& ctx, Backbuffer& bb, MonitorOverlay& m, int slot, const Sprite& sprite,
+    const TrailBuffer& trail, PresentJob& job) noexcept
 {
-    bool add = trail.empty();
-    if (!add)
+    const PixelRect& area = m.area.rect;
+    const SurfaceView view{ static_cast<uint32_t*>(bb.bits), area.Width(), area.Height(), bb.w };
+    job.hwnd = m.hwnd;
+    job.srcDC = bb.memDC;
+    job.ptWin = { area.left, area.top };
+    job.size = { view.w, view.h };
+    job.useDirty = true;
+
+    // Accumulation fades the previous frame in place; its bounds already cover every changed pixel
+    if (gSettings.accumulate)
     {
-        const POINT& p = trail.back().pt;
-        const int dx = ptNow.x - p.x;
-        const int dy = ptNow.y - p.y;
+        TrailRenderStats stats;
+        {
+            ScopedStageTimer timer(StatStage::Composite);
+            stats = m.accumulator.Render(view, sprite, trail, area.left, area.top, TrailClock::now(), gSettings);
+        }
+        CountRenderStats(stats);
+        m.holdsContent = !m.accumulator.LiveBounds().Empty();
+        if (stats.bounds.Empty())
+            return false;
 
-        // Should add a new sample if the cursor has moved at least 1px
-        add = ((dx * dx + dy * dy) >= 1);
+        job.dirty = { stats.bounds.left, stats.bounds.top, stats.bounds.right, stats.bounds.bottom };
+        return true;
     }
 
-    if (add)
+    // Only erase what this surface held when it was last drawn
+    TrailRenderStats stats;
     {
-        trail.push_back({ ptNow, now });
-        if (trail.size() > static_cast<size_t>(kMaxTrailSize))
-            trail.pop_front();
+        ScopedStageTimer timer(StatStage::Composite);
+        ClearRect(view, m.damage.PendingClear(view.w, view.h, slot));
+        stats = ctx.renderer.Render(view, sprite, trail, area.left, area.top, TrailClock::now(), gSettings);
     }
+    CountRenderStats(stats);
+
+    const FrameDamage fd = m.damage.EndFrame(stats.bounds, view.w, view.h, slot);
+    m.holdsContent = !stats.bounds.Empty();
+    if (fd.present.Empty())
+        return false; // Nothing changed on screen
 
-    while (!trail.empty() &&
-        std::chrono::duration_cast<std::chrono::milliseconds>(now - trail.front().t).count() > (gTrailFadeMs + 50.f))
-        trail.pop_front();
+    // Push only the damaged area to the overlay window
+    job.dirty = { fd.present.left, fd.present.top, fd.present.right, fd.present.bottom };
+    return true;
 }
 
-static inline void ReleaseTintCache()
+// Full-screen mode: render every display the trail reaches or that still shows an older frame.
+// Displays the trail stays away from keep their surfaces unallocated and their windows untouched.
+static int DrawTrailFullScreen(OverlayContext& ctx, int slot, const CursorVisual& cv, const TrailBuffer& trail,
+    PresentJob* jobs) noexcept
 {
-    if (sTintDC)
+    int jobCount = 0;
+    for (size_t i = 0; i < ctx.layout.Size(); ++i)
     {
-        if (sTintBMP)
+        MonitorOverlay& m = ctx.monitors[i];
+        if (!m.hwnd)
+            continue;
+
+        // Sprites are scaled to each display, so a trail crossing displays changes size with the pointer
+        const Sprite* sprite = TintSprite(ctx.screenDC, ctx.tmp, cv, m.area.dpi);
+        if (!sprite)
+            continue;
+        if (!m.holdsContent && RectIntersect(TrailBounds(trail, *sprite), m.area.rect).Empty())
+            continue;
+
+        // A failed allocation skips the display this frame and retries on the next
+        Backbuffer& bb = ctx.slots[slot].monitors[i];
+        if (!bb.EnsureSize(ctx.screenDC, m.area.rect.Width(), m.area.rect.Height()))
+            continue;
+
+        // Make sure GDI is done with the DIBs before touching their bits
+        GdiFlush();
+        jobs[jobCount] = PresentJob{};
+        if (DrawTrailMonitor(ctx, bb, m, slot, *sprite, trail, jobs[jobCount]))
+            ++jobCount;
+    }
+
+    // Jobs are presented in order, so the last one returns the slot after the others are done with it
+    if (jobCount > 0)
+        jobs[jobCount - 1].slot = slot;
+    return jobCount;
+}
+
+// Follow mode: render into a pooled surface covering just the trail and move the window there
+static bool DrawTrailFollow(OverlayContext& ctx, int slot, const CursorVisual& cv, const TrailBuffer& trail,
+    POINT cursor, PresentJob& job) noexcept
+{
+    // The window only ever sits on one display at a time, so it takes the sprite of the cursor's
+    const int display = ctx.layout.IndexAt(cursor.x, cursor.y);
+    const Sprite* sprite = TintSprite(ctx.screenDC, ctx.tmp, cv, display >= 0 ? ctx.layout[display].dpi : kBaseDpi);
+    if (!sprite)
+        return false; // Skip frame if allocation failed
+
+    // Make sure GDI is done with the DIBs before touching their bits
+    GdiFlush();
+
+    const PixelRect area = RectIntersect(TrailBounds(trail, *sprite), ctx.layout.Bounds());
+    job.hwnd = ctx.hwnd;
+
+    Backbuffer* surf = nullptr;
+    PixelRect drawn;
+    if (!area.Empty())
+    {
+        surf = ctx.slots[slot].pool.Acquire(area.Width(), area.Height(),
+            [&](Backbuffer& b, int W, int H) { return b.EnsureSize(ctx.screenDC, W, H); });
+        if (!surf)
+            return false;
+
+        // View is limited to the trail area so nothing lands outside what gets cleared
+        const SurfaceView view{ static_cast<uint32_t*>(surf->bits), area.Width(), area.Height(), surf->w };
+        TrailRenderStats stats;
         {
-            if (sTintOld)
-                SelectObject(sTintDC, sTintOld);
-            DeleteObject(sTintBMP);
-            sTintBMP = nullptr;
+            ScopedStageTimer timer(StatStage::Composite);
+            ClearSurface(view);
+            stats = ctx.renderer.Render(view, *sprite, trail, area.left, area.top, TrailClock::now(), gSettings);
         }
-        DeleteDC(sTintDC);
-        sTintDC = nullptr;
+        CountRenderStats(stats);
+        drawn = stats.bounds;
     }
 
-    sTintOld = nullptr;
-    sTintBits = nullptr;
-    sLastCursor = nullptr;
-    sLastW = sLastH = 0;
+    if (drawn.Empty())
+    {
+        if (!ctx.followVisible)
+            return false;
+
+        // Hide job: holds no surface
+        ctx.followVisible = false;
+        return true;
+    }
+
+    // Present just the stamped pixels; this also moves and resizes the window
+    job.slot = slot;
+    job.srcDC = surf->memDC;
+    job.ptWin = { area.left + drawn.left, area.top + drawn.top };
+    job.size = { drawn.Width(), drawn.Height() };
+    job.ptSrc = { drawn.left, drawn.top };
+    job.show = !ctx.followVisible;
+    ctx.followVisible = true;
+    return true;
 }
 
-static void DrawTrail(HWND hwnd, HDC screenDC, Backbuffer& bb, TempIconSurf& tmp,
-    const CursorVisual& cv, const std::deque<Sample>& trail, const RECT& vs) noexcept
+// Renders one frame into the slot and fills a job per window to update; returns the job count
+static int DrawTrail(OverlayContext& ctx, int slot, const CursorVisual& cv, const TrailBuffer& trail, POINT cursor,
+    PresentJob* jobs) noexcept
 {
-    if (!tmp.EnsureSize(screenDC, cv.width, cv.height))
-        return;
+    if (gOverlayMode == OverlayMode::Follow)
+        return DrawTrailFollow(ctx, slot, cv, trail, cursor, jobs[0]) ? 1 : 0;
+    return DrawTrailFullScreen(ctx, slot, cv, trail, jobs);
+}
+
+// Takes the display layout the UI thread last published. Every display starts over with a full
+// clear and present, since its window may have been moved or resized under the old contents.
+static void AdoptLayout(OverlayContext& ctx)
+{
+    std::lock_guard<std::mutex> lock(ctx.layoutLock);
+    ctx.layout = ctx.pendingLayout;
+    if (ctx.visuals)
+        ctx.visuals->SetOrigin(ctx.layout.Bounds().left, ctx.layout.Bounds().top);
+    for (size_t i = 0; i < ctx.layout.Size(); ++i)
+    {
+        MonitorOverlay& m = ctx.monitors[i];
+        m.hwnd = i < ctx.pendingWindows.size() ? ctx.pendingWindows[i] : nullptr;
+        m.area = ctx.layout[i];
+        m.damage.Invalidate();
+        m.accumulator.Reset();
+        m.holdsContent = true;
+    }
+}
+
+// Writes per-stage frame timing and surface memory to the debugger output
+static void ReportPresentStats(const OverlayContext& ctx) noexcept
+{
+    wchar_t line[640];
+    swprintf_s(line, L"CursorBlur [%s, %s]: %llu frames, render avg %.3f max %.3f ms, wait avg %.3f max %.3f ms, "
+        L"queue avg %.3f max %.3f ms, present avg %.3f max %.3f ms, input to present avg %.3f max %.3f ms, "
+        L"peak surface %.1f MB\n",
+        ctx.visuals ? L"dcomp" : gOverlayMode == OverlayMode::Follow ? L"follow" : L"fullscreen",
+        gPacingMode == PacingMode::Vsync ? L"vsync" : L"timer",
+        static_cast<unsigned long long>(ctx.present.count),
+        ctx.render.AvgMs(), ctx.render.maxMs,
+        ctx.wait.AvgMs(), ctx.wait.maxMs,
+        ctx.queue.AvgMs(), ctx.queue.maxMs,
+        ctx.present.AvgMs(), ctx.present.maxMs,
+        ctx.latency.AvgMs(), ctx.latency.maxMs,
+        static_cast<double>(ctx.peakSurfaceBytes) / (1024.0 * 1024.0));
+    OutputDebugStringW(line);
+}
 
-    bb.Clear();
-    const auto now = std::chrono::steady_clock::now();
+// Raw-input sampling thread. A message-only window receives WM_INPUT for every mouse
+// report (RIDEV_INPUTSINK keeps them coming while other apps have focus) and queues the
+// cursor position, so trail resolution follows the mouse rate instead of the frame rate.
+struct InputThread final
+{
+    InputQueue queue;
+    std::thread thread;
+    HWND sink = nullptr;
+    POINT last{};
+    bool hasLast = false;
+    uint64_t dropped = 0; // Samples lost because the render loop fell a full queue behind
+
+    // Idle parking: the render thread sets parked and blocks on wake; motion clears parked and
+    // sets wake. canWake is set when raw input or the mouse hook reports motion.
+    HANDLE wake = nullptr;
+    std::atomic<bool> parked{ false };
+    bool canWake = false;
+
+    bool Start(HINSTANCE hInstance);
+    void Stop() noexcept;
+
+    // Called after motion is queued or seen; costs one fence and an exchange while not parked
+    void WakeIfParked() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked.load(std::memory_order_relaxed) && parked.exchange(false, std::memory_order_acq_rel))
+            SetEvent(wake);
+    }
+};
 
-    // (Re)create tinted bitmap when cursor shape/size changes
-    if (!sTintBMP || !sTintDC || cv.hCur != sLastCursor || cv.width != sLastW || cv.height != sLastH)
+static LRESULT CALLBACK InputSinkProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept
+{
+    InputThread* input = reinterpret_cast<InputThread*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
+    switch (msg)
     {
-        sLastCursor = cv.hCur;
-        sLastW = cv.width;
-        sLastH = cv.height;
+        case WM_INPUT:
+            if (input)
+            {
+                // Cursor position after this report; button and wheel reports do not move it
+                POINT pt{};
+                if (GetCursorPos(&pt) && (!input->hasLast || pt.x != input->last.x || pt.y != input->last.y))
+                {
+                    input->last = pt;
+                    input->hasLast = true;
+                    if (!input->queue.TryPush({ { pt.x, pt.y }, TrailClock::now() }))
+                        ++input->dropped;
+                    input->WakeIfParked();
+                }
+            }
+            break;
+        case WM_DESTROY:
+        {
+            const RAWINPUTDEVICE rid{ 0x01, 0x02, RIDEV_REMOVE, nullptr };
+            RegisterRawInputDevices(&rid, 1, sizeof(rid));
+            PostQuitMessage(0);
+            break;
+        }
+        default:
+            break;
+    }
 
-        if (!sTintDC)
-            sTintDC = CreateCompatibleDC(screenDC);
+    return DefWindowProcW(hwnd, msg, wParam, lParam);
+}
 
-        // Unselect old bitmap safely before deleting
-        if (sTintBMP)
+bool InputThread::Start(HINSTANCE hInstance)
+{
+    std::promise<bool> started;
+    std::future<bool> ready = started.get_future();
+    thread = std::thread([this, hInstance, &started]
+    {
+        SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
+
+        const wchar_t* kInputClass = L"CursorTrailOverlay_InputSink";
+        WNDCLASSEXW wc{ sizeof(WNDCLASSEXW) };
+        wc.lpfnWndProc = InputSinkProc;
+        wc.hInstance = hInstance;
+        wc.lpszClassName = kInputClass;
+        RegisterClassExW(&wc);
+
+        HWND hwnd = CreateWindowExW(0, kInputClass, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, hInstance, nullptr);
+        if (!hwnd)
         {
-            if (sTintOld)
-                SelectObject(sTintDC, sTintOld);
-            DeleteObject(sTintBMP);
-            sTintBMP = nullptr;
-            sTintOld = nullptr;
-            sTintBits = nullptr;
+            started.set_value(false);
+            return;
         }
 
-        BITMAPINFO bi = MakeBitmapInfo(cv.width, cv.height);
-        sTintBMP = CreateDIBSection(screenDC, &bi, DIB_RGB_COLORS, &sTintBits, nullptr, 0);
-        if (!sTintBMP || !sTintBits)
-            return; // Skip frame if allocation failed
+        // Generic desktop page, mouse usage
+        SetWindowLongPtr(hwnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
+        const RAWINPUTDEVICE rid{ 0x01, 0x02, RIDEV_INPUTSINK, hwnd };
+        if (!RegisterRawInputDevices(&rid, 1, sizeof(rid)))
+        {
+            DestroyWindow(hwnd);
+            started.set_value(false);
+            return;
+        }
+
+        sink = hwnd;
+        started.set_value(true);
+
+        MSG msg{};
+        while (GetMessageW(&msg, nullptr, 0, 0) > 0)
+            DispatchMessageW(&msg);
+    });
+
+    if (ready.get())
+        return true;
+
+    thread.join();
+    return false;
+}
+
+void InputThread::Stop() noexcept
+{
+    if (sink)
+        PostMessageW(sink, WM_CLOSE, 0, 0);
+    if (thread.joinable())
+        thread.join();
+    sink = nullptr;
+}
+
+// Wakes a parked render thread on mouse motion when raw input is unavailable
+static InputThread* sHookInput = nullptr;
+
+static LRESULT CALLBACK IdleMouseHook(int code, WPARAM wParam, LPARAM lParam) noexcept
+{
+    if (code == HC_ACTION && wParam == WM_MOUSEMOVE && sHookInput)
+        sHookInput->WakeIfParked();
+    return CallNextHookEx(nullptr, code, wParam, lParam);
+}
+
+// Small stable id per cursor image for trace recordings, in order of first appearance; 0 for none
+static uint16_t CursorShapeId(std::vector<HCURSOR>& shapes, HCURSOR hCur)
+{
+    if (!hCur)
+        return 0;
+    const auto it = std::find(shapes.begin(), shapes.end(), hCur);
+    if (it != shapes.end())
+        return static_cast<uint16_t>(it - shapes.begin() + 1);
+    if (shapes.size() >= 0xFFFF)
+        return 0;
+    shapes.push_back(hCur);
+    return static_cast<uint16_t>(shapes.size());
+}
+
+// Sleeps until a deadline with sub-millisecond accuracy. A high-resolution waitable timer
+// (Windows 10 1803 and later) covers most of the wait and a short spin the rest; without one
+// the thread sleeps at the system timer resolution and spins longer.
+struct FrameTimer final
+{
+    HANDLE timer = nullptr;
+
+    FrameTimer() noexcept
+        : timer(CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS))
+    {
+    }
 
-        sTintOld = SelectObject(sTintDC, sTintBMP);
+    ~FrameTimer()
+    {
+        if (timer)
+            CloseHandle(timer);
+    }
 
-        // Draw and tint cursor once
-        PatBlt(sTintDC, 0, 0, cv.width, cv.height, BLACKNESS);
-        DrawIconEx(sTintDC, 0, 0, cv.hCur, cv.width, cv.height, 0, nullptr, DI_NORMAL);
+    FrameTimer(const FrameTimer&) = delete;
+    FrameTimer& operator=(const FrameTimer&) = delete;
 
-        DWORD* px = static_cast<DWORD*>(sTintBits);
-        const UINT count = static_cast<UINT>(cv.width * cv.height);
-        for (UINT i = 0; i < count; ++i)
+    void WaitUntil(TrailClock::time_point deadline) const noexcept
+    {
+        using namespace std::chrono;
+        const auto spin = timer ? microseconds(200) : microseconds(2000);
+        const auto sleep = deadline - spin - TrailClock::now();
+        if (sleep > TrailClock::duration::zero())
         {
-            BYTE* p = reinterpret_cast<BYTE*>(&px[i]);
-            p[2] = static_cast<BYTE>((p[2] * TintR) / 255);
-            p[1] = static_cast<BYTE>((p[1] * TintG) / 255);
-            p[0] = static_cast<BYTE>((p[0] * TintB) / 255);
+            LARGE_INTEGER due{};
+            due.QuadPart = -static_cast<LONGLONG>(duration_cast<nanoseconds>(sleep).count() / 100); // Relative, 100 ns units
+            if (timer && SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE))
+                WaitForSingleObject(timer, INFINITE);
+            else
+                std::this_thread::sleep_for(sleep);
         }
+
+        while (TrailClock::now() < deadline)
+            std::this_thread::yield();
     }
+};
 
+// True when no overlay window shows trail pixels, so an empty trail needs no more frames
+static bool OverlaysClear(const OverlayContext& ctx) noexcept
+{
+    if (ctx.visuals)
+        return !ctx.visuals->ShowsTrail();
+    if (gOverlayMode == OverlayMode::Follow)
+        return !ctx.followVisible;
+    for (size_t i = 0; i < ctx.layout.Size(); ++i)
+    {
+        if (ctx.monitors[i].hwnd && ctx.monitors[i].holdsContent)
+            return false;
+    }
+    return true;
+}
 
-    // Copy cached tinted cursor into tmp for per-pixel alpha blends below
-    PatBlt(tmp.memDC, 0, 0, tmp.w, tmp.h, BLACKNESS);
-    if (!sTintBMP)
-        return; // Safety: creation may have failed above
-    BitBlt(tmp.memDC, 0, 0, cv.width, cv.height, sTintDC, 0, 0, SRCCOPY);
+// Blocks the render thread until the mouse moves or quit is set
+static void ParkUntilMotion(OverlayContext& ctx, InputThread& input) noexcept
+{
+    AddCounter(StatCounter::IdleParks);
+    input.parked.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Samples queued before parked was visible would otherwise not wake us
+    while (input.parked.load(std::memory_order_acquire) && input.queue.SizeApprox() == 0 &&
+        !ctx.quit.load(std::memory_order_acquire))
+        WaitForSingleObject(input.wake, INFINITE);
+    input.parked.store(false, std::memory_order_relaxed);
+}
+
+// DWM composition clock. Waits on DCompositionWaitForCompositorClock where dcomp.dll exports it
+// (Windows 11), otherwise on DwmFlush, and reads the vblank schedule from DWM timing info.
+struct CompositorClock final
+{
+    using WaitForClockFn = DWORD(WINAPI*)(UINT, const HANDLE*, DWORD);
+
+    HMODULE dcomp = nullptr;
+    WaitForClockFn waitForClock = nullptr;
+    LARGE_INTEGER qpcFrequency{};
+
+    CompositorClock() noexcept : dcomp(LoadLibraryW(L"dcomp.dll"))
+    {
+        if (dcomp)
+            waitForClock = reinterpret_cast<WaitForClockFn>(GetProcAddress(dcomp, "DCompositionWaitForCompositorClock"));
+        QueryPerformanceFrequency(&qpcFrequency);
+    }
+
+    ~CompositorClock()
+    {
+        if (dcomp)
+            FreeLibrary(dcomp);
+    }
+
+    CompositorClock(const CompositorClock&) = delete;
+    CompositorClock& operator=(const CompositorClock&) = delete;
+
+    // Blocks until the next composition; false when there is no composition clock to wait on
+    [[nodiscard]] bool Wait() const noexcept
+    {
+        if (waitForClock)
+            return waitForClock(0, nullptr, 100) == WAIT_OBJECT_0;
+        return SUCCEEDED(DwmFlush());
+    }
+
+    // First vblank after now and the refresh period; both are left alone if DWM cannot report them
+    bool NextVBlank(TrailClock::time_point now, TrailClock::time_point& vblank,
+        TrailClock::duration& period) const noexcept
+    {
+        DWM_TIMING_INFO ti{};
+        ti.cbSize = sizeof(ti);
+        if (FAILED(DwmGetCompositionTimingInfo(nullptr, &ti)) || !ti.qpcRefreshPeriod || !qpcFrequency.QuadPart)
+            return false;
+
+        LARGE_INTEGER qpcNow{};
+        QueryPerformanceCounter(&qpcNow);
+        const auto ticks = [&](int64_t n)
+        {
+            return std::chrono::duration_cast<TrailClock::duration>(
+                std::chrono::duration<double>(static_cast<double>(n) / static_cast<double>(qpcFrequency.QuadPart)));
+        };
+
+        period = ticks(static_cast<int64_t>(ti.qpcRefreshPeriod));
+        vblank = now - ticks(qpcNow.QuadPart - static_cast<int64_t>(ti.qpcVBlank));
+        if (vblank <= now)
+            vblank += period * ((now - vblank) / period + 1);
+        return true;
+    }
+};
+
+// Composition mode: places the frame's sprite visuals and commits them from the render thread,
+// scaled to the DPI of the cursor's display. A cursor that cannot be rasterized hides the trail.
+static void PresentVisuals(OverlayContext& ctx, const CursorVisual& cv, const TrailBuffer& trail, int display,
+    TrailClock::time_point started, TrailClock::time_point& lastInput) noexcept
+{
+    static const Sprite kNoSprite;
+    const Sprite* sprite = TintSprite(ctx.screenDC, ctx.tmp, cv, display >= 0 ? ctx.layout[display].dpi : kBaseDpi);
+
+    const auto t0 = TrailClock::now();
+    const TrailRenderStats stats = ctx.visuals->Present(sprite ? *sprite : kNoSprite, trail, t0, gSettings);
+    const auto done = TrailClock::now();
+    CountRenderStats(stats);
+    AddStage(ctx.present, StatStage::Present, done - t0);
+    AddCounter(StatCounter::Presents);
+
+    const auto input = trail.Empty() ? TrailClock::time_point{} : trail.TimePoint(trail.Size() - 1);
+    if (input > lastInput)
+    {
+        AddStage(ctx.latency, StatStage::Latency, done - input);
+        lastInput = input;
+    }
+    ctx.frameCostNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(done - started).count(),
+        std::memory_order_release);
+}
+
+// Render thread: samples input, renders and queues frames until quit is set. Frames are paced
+// by the refresh rate of the display the cursor is on, or in vsync mode by the composition
+// clock. Every sample fed to the trail also goes to recorder when it is recording.
+static void RenderLoop(OverlayContext& ctx, InputThread& input, bool rawInput, TraceRecorder& recorder) noexcept
+{
+    TrailBuffer trail(kMaxTrailSize);
+    CursorVisual cv{};
+    std::vector<HCURSOR> shapes;
+    int slot = -1; // Slot held between frames when nothing was presented from it
+    FramePacer pacer;
+    const FrameTimer timer;
+    const CompositorClock clock;
+    VsyncScheduler vsync;
+    bool useVsync = gPacingMode == PacingMode::Vsync;
+    bool resumed = false; // First frame after parking starts at once
+    TrailClock::time_point lastTick{};
+    TrailClock::time_point lastInput{}; // Composition mode: newest sample already presented
+    POINT polled{};
+    bool hasPolled = false;
+
+    while (!ctx.quit.load(std::memory_order_acquire))
+    {
+        // Vsync: wait for the composition that takes the previous frame, then sleep until the
+        // next frame's cost ahead of the one after. Falls back to the timer for good if the
+        // composition clock fails.
+        TrailClock::duration target = pacer.Period();
+        if (useVsync && !resumed && !clock.Wait())
+            useVsync = false;
+        if (resumed)
+        {
+            resumed = false;
+        }
+        else if (useVsync)
+        {
+            const int64_t costNs = ctx.frameCostNs.exchange(-1, std::memory_order_acq_rel);
+            if (costNs >= 0)
+                vsync.AddFrameCost(std::chrono::nanoseconds(costNs));
+
+            const auto now = TrailClock::now();
+            TrailClock::time_point vblank = now + target;
+            clock.NextVBlank(now, vblank, target);
+            timer.WaitUntil(vsync.WakeTime(now, vblank, target));
+        }
+        else
+        {
+            timer.WaitUntil(pacer.Deadline(TrailClock::now()));
+        }
+
+        const auto frameStart = TrailClock::now();
+        if (lastTick != TrailClock::time_point{})
+            RecordFrameInterval(frameStart - lastTick, target);
+        pacer.FrameStarted(frameStart);
+        lastTick = frameStart;
+
+        CURSORINFO ci{ sizeof(ci) };
+        const bool cursorShown = GetCursorInfo(&ci) && ci.flags == CURSOR_SHOWING && ci.hCursor;
+        const bool recording = recorder.Recording();
+        const uint16_t shape = recording ? CursorShapeId(shapes, ci.hCursor) : 0;
+
+        // Take every position the input thread saw since the last frame
+        if (rawInput)
+        {
+            ScopedStageTimer timer(StatStage::Input);
+            size_t drained;
+            if (recording)
+            {
+                drained = DrainInput(input.queue, trail, lastTick, gSettings,
+                    [&](const InputSample& s) { recorder.Record(s.pt, s.t, shape, cursorShown); });
+            }
+            else
+            {
+                drained = DrainInput(input.queue, trail, lastTick, gSettings);
+            }
+            AddCounter(StatCounter::InputSamples, drained);
+        }
+        else
+        {
+            // Only a moved cursor is sampled, so a still one lets the trail empty out and the loop idle
+            POINT cur{};
+            GetCursorPos(&cur);
+            if (!hasPolled || cur.x != polled.x || cur.y != polled.y)
+            {
+                polled = cur;
+                hasPolled = true;
+                if (recording)
+                    recorder.Record({ cur.x, cur.y }, lastTick, shape, cursorShown);
+                UpdateTrail(trail, { cur.x, cur.y }, lastTick, gSettings);
+            }
+            else
+            {
+                ExpireTrail(trail, lastTick, gSettings);
+            }
+        }
+
+        // Pick up display changes; the UI thread has already moved the windows
+        if (ctx.layoutChanged.exchange(false, std::memory_order_acq_rel))
+            AdoptLayout(ctx);
+
+        // Pace to the display the cursor is on, where the trail is being watched
+        const int display = ctx.layout.IndexAt(ci.ptScreenPos.x, ci.ptScreenPos.y);
+        if (display >= 0 && ctx.layout[display].refreshHz != pacer.Rate())
+            pacer.SetRate(ctx.layout[display].refreshHz);
+
+        if (!cursorShown)
+            ExpireTrail(trail, TrailClock::now(), gSettings);
+        else
+            RefreshCursorVisual(cv, ci);
+
+        // Idle: the trail has faded and its last empty frame is presented. Block on input
+        // instead of polling, and wake immediately on motion.
+        if (trail.Empty() && OverlaysClear(ctx))
+        {
+            if (input.canWake)
+            {
+                ParkUntilMotion(ctx, input);
+                lastTick = {}; // The parked gap is not a frame interval
+                resumed = true;
+            }
+            continue;
+        }
+
+        // Composition mode needs no surfaces and no present thread
+        if (ctx.visuals)
+        {
+            PresentVisuals(ctx, cv, trail, display, frameStart, lastInput);
+            AddStage(ctx.render, StatStage::Frame, TrailClock::now() - lastTick);
+            AddCounter(StatCounter::Frames);
+            SetGauge(StatGauge::SamplesAlive, static_cast<int64_t>(trail.Size()));
+            continue;
+        }
+
+        // Wait for the present thread to hand back a surface
+        TrailClock::duration waited{};
+        if (slot < 0)
+        {
+            const auto w0 = TrailClock::now();
+            while (!ctx.freeSlots.TryPop(slot))
+            {
+                if (ctx.quit.load(std::memory_order_acquire))
+                    return;
+                WaitForSingleObject(ctx.slotReady, 100);
+            }
+            waited = TrailClock::now() - w0;
+            AddStage(ctx.wait, StatStage::Wait, waited);
+        }
+
+        PresentJob jobs[kMaxMonitors];
+        const int jobCount = DrawTrail(ctx, slot, cv, trail, ci.ptScreenPos, jobs);
+        AddStage(ctx.render, StatStage::Frame, TrailClock::now() - lastTick - waited);
+        AddCounter(StatCounter::Frames);
+        SetGauge(StatGauge::SamplesAlive, static_cast<int64_t>(trail.Size()));
+        ctx.peakSurfaceBytes = std::max(ctx.peakSurfaceBytes, ctx.SurfaceBytes());
+        SetGauge(StatGauge::SurfaceBytes, static_cast<int64_t>(ctx.peakSurfaceBytes));
+        if (jobCount == 0)
+            continue;
+
+        if (jobs[jobCount - 1].slot >= 0)
+            slot = -1; // Owned by the present thread until it comes back through freeSlots
+
+        // Never full: at most one job per display and slot plus the hide jobs between them
+        const auto input = trail.Empty() ? TrailClock::time_point{} : trail.TimePoint(trail.Size() - 1);
+        const auto queued = TrailClock::now();
+        for (int i = 0; i < jobCount; ++i)
+        {
+            jobs[i].started = frameStart;
+            jobs[i].input = input;
+            jobs[i].queued = queued;
+            ctx.presentQueue.TryPush(jobs[i]);
+        }
+        SetEvent(ctx.jobReady);
+    }
+}
+
+// Present thread: pushes queued frames to the compositor and returns their slots
+static void PresentLoop(OverlayContext& ctx) noexcept
+{
+    TrailClock::time_point lastInput{}; // Latency is counted once per input sample, not per redraw of it
+    while (true)
+    {
+        PresentJob job;
+        if (!ctx.presentQueue.TryPop(job))
+        {
+            if (ctx.quit.load(std::memory_order_acquire))
+                return;
+            WaitForSingleObject(ctx.jobReady, 100);
+            continue;
+        }
+
+        AddStage(ctx.queue, StatStage::Queue, TrailClock::now() - job.queued);
+        if (job.srcDC)
+        {
+            Present(ctx, job);
+            if (job.show)
+                ShowWindowAsync(job.hwnd, SW_SHOWNOACTIVATE);
+        }
+        else
+        {
+            ShowWindowAsync(job.hwnd, SW_HIDE);
+        }
+
+        const auto done = TrailClock::now();
+        if (job.srcDC && job.input > lastInput)
+        {
+            AddStage(ctx.latency, StatStage::Latency, done - job.input);
+            lastInput = job.input;
+        }
+
+        if (job.slot >= 0)
+        {
+            ctx.frameCostNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(done - job.started).count(),
+                std::memory_order_release);
+            ctx.freeSlots.TryPush(job.slot);
+            SetEvent(ctx.slotReady);
+        }
+    }
+}
 
-    // Draw samples in order from oldest to newest
-    for (int i = static_cast<int>(trail.size()) - 2; i >= 0; --i)
+// Exact refresh rate of an active display source, by its GDI device name
+struct SourceRefreshRate
+{
+    WCHAR device[CCHDEVICENAME];
+    double hz;
+};
+
+// Refresh rates of the active display paths as the rationals the display runs at (59.94 Hz
+// rather than the 59 or 60 DEVMODE rounds it to); empty if the configuration cannot be read
+static std::vector<SourceRefreshRate> QuerySourceRefreshRates()
+{
+    std::vector<SourceRefreshRate> rates;
+    std::vector<DISPLAYCONFIG_PATH_INFO> paths;
+    std::vector<DISPLAYCONFIG_MODE_INFO> modes;
+    LONG result = ERROR_INSUFFICIENT_BUFFER;
+    while (result == ERROR_INSUFFICIENT_BUFFER)
     {
-        const Sample& s0 = trail[i];
-        const Sample& s1 = trail[i + 1];
+        // Paths can be added between the two calls, so retry with fresh sizes
+        UINT32 pathCount = 0, modeCount = 0;
+        if (GetDisplayConfigBufferSizes(QDC_ONLY_ACTIVE_PATHS, &pathCount, &modeCount) != ERROR_SUCCESS)
+            return rates;
+        paths.resize(pathCount);
+        modes.resize(modeCount);
+        result = QueryDisplayConfig(QDC_ONLY_ACTIVE_PATHS, &pathCount, paths.data(), &modeCount, modes.data(), nullptr);
+        paths.resize(pathCount);
+    }
+    if (result != ERROR_SUCCESS)
+        return rates;
 
-        const float age0 = static_cast<float>(
-            std::chrono::duration_cast<std::chrono::milliseconds>(now - s0.t).count());
-        if (age0 > gTrailFadeMs)
+    for (const DISPLAYCONFIG_PATH_INFO& path : paths)
+    {
+        const DISPLAYCONFIG_RATIONAL& rate = path.targetInfo.refreshRate;
+        if (rate.Numerator == 0 || rate.Denominator == 0)
             continue;
 
-        const float dx = static_cast<float>(s1.pt.x - s0.pt.x);
-        const float dy = static_cast<float>(s1.pt.y - s0.pt.y);
-        const float distSq = dx * dx + dy * dy;
-        if (distSq < 1.f)
+        DISPLAYCONFIG_SOURCE_DEVICE_NAME source{};
+        source.header.type = DISPLAYCONFIG_DEVICE_INFO_GET_SOURCE_NAME;
+        source.header.size = sizeof(source);
+        source.header.adapterId = path.sourceInfo.adapterId;
+        source.header.id = path.sourceInfo.id;
+        if (DisplayConfigGetDeviceInfo(&source.header) != ERROR_SUCCESS)
             continue;
 
-        const float dist = std::sqrtf(distSq);
-        const int steps = static_cast<int>(std::ceilf(dist));
-        const float stepFrac = 1.f / static_cast<float>(steps);
+        SourceRefreshRate entry{};
+        std::memcpy(entry.device, source.viewGdiDeviceName, sizeof(entry.device));
+        entry.device[CCHDEVICENAME - 1] = L'\0';
+        entry.hz = static_cast<double>(rate.Numerator) / static_cast<double>(rate.Denominator);
+        rates.push_back(entry);
+    }
+    return rates;
+}
+
+struct MonitorEnumeration
+{
+    std::vector<MonitorArea> areas;
+    std::vector<SourceRefreshRate> rates;
+};
 
-        // Interpolate between samples to fill gaps
-        for (int j = steps; j >= 0; --j)
+static BOOL CALLBACK AddMonitorArea(HMONITOR monitor, HDC, RECT* rc, LPARAM param)
+{
+    auto& e = *reinterpret_cast<MonitorEnumeration*>(param);
+    UINT dpiX = kBaseDpi, dpiY = kBaseDpi;
+    if (FAILED(GetDpiForMonitor(monitor, MDT_EFFECTIVE_DPI, &dpiX, &dpiY)))
+        dpiX = kBaseDpi;
+
+    // The display path's exact rate, else the whole-hertz mode rate, where 0 and 1 stand for
+    // the hardware default
+    double refreshHz = 0.0;
+    MONITORINFOEXW mi{};
+    mi.cbSize = sizeof(mi);
+    if (GetMonitorInfoW(monitor, &mi))
+    {
+        for (const SourceRefreshRate& rate : e.rates)
         {
-            const float t = j * stepFrac;
-            const POINT p{
-                static_cast<LONG>(std::lround(s0.pt.x + dx * t)),
-                static_cast<LONG>(std::lround(s0.pt.y + dy * t))
-            };
-
-            // Calculate alpha for sample
-            const float fade = std::max(0.f, 1.f - (age0 + (age0 * t * 0.1f)) / gTrailFadeMs);
-            const float speedFactor = std::clamp(dist * gSensitivity, 0.f, 1.f);
-            const BYTE a = static_cast<BYTE>(std::clamp(gTrailMaxAlpha * fade * speedFactor, 0.f, 255.f));
-            if (a < 3)
-                continue;
-
-            const int dstX = p.x - vs.left - cv.hotX;
-            const int dstY = p.y - vs.top - cv.hotY;
-
-            const BLENDFUNCTION bf{ AC_SRC_OVER, 0, a, AC_SRC_ALPHA };
-            AlphaBlend(bb.memDC, dstX, dstY, cv.width, cv.height,
-                tmp.memDC, 0, 0, cv.width, cv.height, bf);
+            if (_wcsicmp(rate.device, mi.szDevice) == 0)
+            {
+                refreshHz = rate.hz;
+                break;
+            }
         }
+
+        DEVMODEW dm{};
+        dm.dmSize = sizeof(dm);
+        if (refreshHz <= 0.0 && EnumDisplaySettingsW(mi.szDevice, ENUM_CURRENT_SETTINGS, &dm) && dm.dmDisplayFrequency > 1)
+            refreshHz = static_cast<double>(dm.dmDisplayFrequency);
     }
+    if (refreshHz <= 0.0)
+        refreshHz = 60.0;
 
-    // Push entire frame to the overlay window
-    const POINT ptSrc{ 0,0 };
-    const SIZE sz{ bb.w, bb.h };
-    const POINT ptWin{ vs.left, vs.top };
-    const BLENDFUNCTION bfW{ AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
-    UpdateLayeredWindow(
-        hwnd,
-        screenDC,
-        const_cast<POINT*>(&ptWin),
-        const_cast<SIZE*>(&sz),
-        bb.memDC,
-        const_cast<POINT*>(&ptSrc),
-        0,
-        const_cast<BLENDFUNCTION*>(&bfW),
-        ULW_ALPHA);
-}
-
-// Overlay window handler
+    e.areas.push_back({ { rc->left, rc->top, rc->right, rc->bottom }, static_cast<int>(dpiX), refreshHz });
+    return TRUE;
+}
+
+// Current displays with their effective DPI and refresh rate; the virtual screen stands in if
+// enumeration fails
+static MonitorLayout EnumerateMonitors()
+{
+    MonitorEnumeration e;
+    e.rates = QuerySourceRefreshRates();
+    EnumDisplayMonitors(nullptr, nullptr, AddMonitorArea, reinterpret_cast<LPARAM>(&e));
+    if (e.areas.empty())
+    {
+        const RECT vs = GetVirtualScreenRect();
+        e.areas.push_back({ { vs.left, vs.top, vs.right, vs.bottom }, kBaseDpi });
+    }
+    return MonitorLayout(e.areas);
+}
+
+// Creates a click-through topmost overlay window that the context's window procedures can reach.
+// A composition window has no redirection surface; DirectComposition draws all of its content.
+static HWND CreateOverlayWindow(OverlayContext& ctx, const wchar_t* windowClass, const PixelRect& r,
+    bool composition = false) noexcept
+{
+    HWND hwnd = CreateWindowExW(
+        WS_EX_LAYERED | WS_EX_TRANSPARENT | WS_EX_TOOLWINDOW | WS_EX_TOPMOST | WS_EX_NOACTIVATE |
+            (composition ? WS_EX_NOREDIRECTIONBITMAP : 0),
+        windowClass, L"", WS_POPUP,
+        r.left, r.top, r.Width(), r.Height(),
+        nullptr, nullptr, ctx.hInstance, nullptr);
+    if (!hwnd)
+        return nullptr;
+
+    // Make the window click-through
+    LONG_PTR ex = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
+    ex |= WS_EX_LAYERED | WS_EX_TRANSPARENT | WS_EX_TOOLWINDOW | WS_EX_TOPMOST | WS_EX_NOACTIVATE;
+    SetWindowLongPtr(hwnd, GWL_EXSTYLE, ex);
+    SetWindowLongPtr(hwnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(&ctx));
+
+    // Layered windows stay hidden until given content; this one takes it from its composition target
+    if (composition)
+        SetLayeredWindowAttributes(hwnd, 0, 255, LWA_ALPHA);
+
+    ShowWindow(hwnd, SW_SHOW);
+    UpdateWindow(hwnd);
+
+    // Exclude from desktop peek
+    BOOL exclude = TRUE;
+    DwmSetWindowAttribute(hwnd, DWMWA_EXCLUDED_FROM_PEEK, &exclude, sizeof(exclude));
+    return hwnd;
+}
+
+// UI thread: re-enumerates the displays, fits one overlay window to each in full-screen mode and
+// publishes the result to the render thread. Windows are reused in order and the main one is
+// never destroyed; a job still queued for a destroyed window fails harmlessly.
+static void SyncMonitorWindows(OverlayContext& ctx)
+{
+    const MonitorLayout layout = EnumerateMonitors();
+    if (ctx.visuals)
+    {
+        const PixelRect r = layout.Bounds();
+        SetWindowPos(ctx.hwnd, HWND_TOPMOST, r.left, r.top, r.Width(), r.Height(), SWP_NOACTIVATE | SWP_NOSENDCHANGING);
+    }
+    else if (gOverlayMode == OverlayMode::FullScreen)
+    {
+        for (size_t i = 0; i < layout.Size(); ++i)
+        {
+            const PixelRect& r = layout[i].rect;
+            if (i < ctx.monitorWindows.size())
+            {
+                SetWindowPos(ctx.monitorWindows[i], HWND_TOPMOST, r.left, r.top, r.Width(), r.Height(),
+                    SWP_NOACTIVATE | SWP_NOSENDCHANGING);
+            }
+            else if (HWND hwnd = CreateOverlayWindow(ctx, kMonitorClass, r))
+            {
+                ctx.monitorWindows.push_back(hwnd);
+            }
+            else
+            {
+                break; // Displays without a window are not drawn
+            }
+        }
+
+        while (ctx.monitorWindows.size() > std::max<size_t>(layout.Size(), 1))
+        {
+            DestroyWindow(ctx.monitorWindows.back());
+            ctx.monitorWindows.pop_back();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(ctx.layoutLock);
+    if (layout == ctx.pendingLayout && ctx.pendingWindows == ctx.monitorWindows)
+        return; // Moving a window across displays re-sends WM_DPICHANGED for nothing new
+    ctx.pendingLayout = layout;
+    ctx.pendingWindows = ctx.monitorWindows;
+    ctx.layoutChanged.store(true, std::memory_order_release);
+}
+
+// Main overlay window handler. Runs on the UI thread, which does nothing but pump messages
+// and refit the overlays when the displays change.
 LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept
 {
-    RECT* pVs = reinterpret_cast<RECT*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
     switch (msg)
     {
         case WM_DESTROY:
-            PostQuitMessage(0);
+            // A composition window given up at startup is not the main window
+            if (const OverlayContext* ctx = reinterpret_cast<const OverlayContext*>(GetWindowLongPtr(hwnd, GWLP_USERDATA));
+                !ctx || ctx->hwnd == hwnd)
+                PostQuitMessage(0);
             break;
         case WM_ERASEBKGND:
             return 1;
         case WM_DISPLAYCHANGE:
-            if (pVs)
-                *pVs = GetVirtualScreenRect();
+        case WM_DPICHANGED:
+        case kMsgSyncMonitors:
+            if (OverlayContext* ctx = reinterpret_cast<OverlayContext*>(GetWindowLongPtr(hwnd, GWLP_USERDATA)))
+                SyncMonitorWindows(*ctx);
+            return 0;
+        default:
             break;
+    }
+
+    return DefWindowProc(hwnd, msg, wParam, lParam);
+}
+
+// Overlay windows of the other displays; a DPI change on their display is handed to the main window
+LRESULT CALLBACK MonitorWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept
+{
+    switch (msg)
+    {
+        case WM_ERASEBKGND:
+            return 1;
+        case WM_DPICHANGED:
+            if (const OverlayContext* ctx = reinterpret_cast<const OverlayContext*>(GetWindowLongPtr(hwnd, GWLP_USERDATA)))
+                PostMessageW(ctx->hwnd, kMsgSyncMonitors, 0, 0);
+            return 0;
         default:
             break;
     }
@@ -427,9 +1456,9 @@ int WINAPI wWinMain(
 
         while (token)
         {
-            ParseCommandValue(token, { L"sensitivity", L"s" }, context, gSensitivity, 0.001f, 1.0f);
-            ParseCommandValue(token, { L"fade", L"f" }, context, gTrailFadeMs, 1.f, 1000.f);
-            ParseCommandValue(token, { L"alpha", L"a" }, context, gTrailMaxAlpha, (BYTE)1, (BYTE)255);
+            ParseCommandValue(token, { L"sensitivity", L"s" }, context, gSettings.sensitivity, 0.001f, 1.0f);
+            ParseCommandValue(token, { L"fade", L"f" }, context, gSettings.fadeMs, 1.f, 1000.f);
+            ParseCommandValue(token, { L"alpha", L"a" }, context, gSettings.maxAlpha, (BYTE)1, (BYTE)255);
 
             COLORREF dummyColor{};
             ParseCommandValue(token, { L"color", L"c" }, context, dummyColor, COLORREF(0), COLORREF(0),
@@ -438,12 +1467,87 @@ int WINAPI wWinMain(
                     if (*val == L'#') ++val;
                     unsigned int rgb = 0;
                     if (swscanf_s(val, L"%x", &rgb) == 1) {
-                        TintR = (rgb >> 16) & 0xFF;
-                        TintG = (rgb >> 8) & 0xFF;
-                        TintB = rgb & 0xFF;
+                        gSettings.tintR = (rgb >> 16) & 0xFF;
+                        gSettings.tintG = (rgb >> 8) & 0xFF;
+                        gSettings.tintB = rgb & 0xFF;
                     }
                 });
 
+            int dummyMode{};
+            ParseCommandValue(token, { L"window", L"w" }, context, dummyMode, 0, 0,
+                [](const wchar_t* val)
+                {
+                    if (_wcsicmp(val, L"follow") == 0)
+                        gOverlayMode = OverlayMode::Follow;
+                    else if (_wcsicmp(val, L"full") == 0)
+                        gOverlayMode = OverlayMode::FullScreen;
+                });
+
+            int dummyMethod{};
+            ParseCommandValue(token, { L"renderer", L"r" }, context, dummyMethod, 0, 0,
+                [](const wchar_t* val)
+                {
+                    if (_wcsicmp(val, L"stamp") == 0)
+                        gSettings.method = RenderMethod::Stamp;
+                    else if (_wcsicmp(val, L"swept") == 0)
+                        gSettings.method = RenderMethod::Swept;
+                    else if (_wcsicmp(val, L"subpixel") == 0)
+                        gSettings.method = RenderMethod::Subpixel;
+                });
+            ParseCommandValue(token, { L"spacing", L"sp" }, context, gSettings.stampSpacing, 0.25f, 8.f);
+
+            int dummyCoalesce{};
+            ParseCommandValue(token, { L"coalesce", L"co" }, context, dummyCoalesce, 0, 0,
+                [](const wchar_t* val)
+                {
+                    if (_wcsicmp(val, L"on") == 0)
+                        gSettings.coalesce = true;
+                    else if (_wcsicmp(val, L"off") == 0)
+                        gSettings.coalesce = false;
+                });
+            ParseCommandValue(token, { L"cull", L"cu" }, context, gSettings.cullAlpha, (BYTE)0, (BYTE)255);
+            ParseCommandValue(token, { L"error", L"er" }, context, gSettings.errorBudget, (BYTE)0, (BYTE)255);
+
+            int dummyPacing{};
+            ParseCommandValue(token, { L"pacing", L"p" }, context, dummyPacing, 0, 0,
+                [](const wchar_t* val)
+                {
+                    if (_wcsicmp(val, L"timer") == 0)
+                        gPacingMode = PacingMode::Timer;
+                    else if (_wcsicmp(val, L"vsync") == 0)
+                        gPacingMode = PacingMode::Vsync;
+                });
+
+            int dummyPresenter{};
+            ParseCommandValue(token, { L"presenter", L"pr" }, context, dummyPresenter, 0, 0,
+                [](const wchar_t* val)
+                {
+                    if (_wcsicmp(val, L"layered") == 0)
+                        gPresenterMode = PresenterMode::Layered;
+                    else if (_wcsicmp(val, L"dcomp") == 0)
+                        gPresenterMode = PresenterMode::Composition;
+                });
+
+            ParseCommandValue(token, { L"threads", L"t" }, context, gCompositeThreads, 1, 8);
+
+            int dummyStats{};
+            ParseCommandValue(token, { L"stats", L"st" }, context, dummyStats, 0, 0,
+                [](const wchar_t* val) { wcsncpy_s(gStatsPath, val, _TRUNCATE); });
+
+            int dummyRecord{};
+            ParseCommandValue(token, { L"record", L"rec" }, context, dummyRecord, 0, 0,
+                [](const wchar_t* val) { wcsncpy_s(gRecordPath, val, _TRUNCATE); });
+
+            int dummyHistory{};
+            ParseCommandValue(token, { L"history", L"h" }, context, dummyHistory, 0, 0,
+                [](const wchar_t* val)
+                {
+                    if (_wcsicmp(val, L"redraw") == 0)
+                        gSettings.accumulate = false;
+                    else if (_wcsicmp(val, L"accumulate") == 0)
+                        gSettings.accumulate = true;
+                });
+
             token = wcstok_s(nullptr, L" ", &context);
         }
     }
@@ -452,134 +1556,143 @@ int WINAPI wWinMain(
     if (!SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2))
         SetProcessDPIAware();
 
-    // Register window class
-    const wchar_t* kClass = L"CursorTrailOverlay_CustomCursor";
+    // Register window classes
     WNDCLASSEXW wc{ sizeof(WNDCLASSEXW) };
     wc.lpfnWndProc = WndProc;
     wc.hInstance = hInstance;
     wc.hCursor = LoadCursor(nullptr, IDC_ARROW);
     wc.hbrBackground = (HBRUSH)GetStockObject(BLACK_BRUSH);
-    wc.lpszClassName = kClass;
+    wc.lpszClassName = kOverlayClass;
+    RegisterClassExW(&wc);
+    wc.lpfnWndProc = MonitorWndProc;
+    wc.lpszClassName = kMonitorClass;
     RegisterClassExW(&wc);
 
-    // Create full-screen transparent overlay window
-    RECT vs = GetVirtualScreenRect();
-    HWND hwnd = CreateWindowExW(
-        WS_EX_LAYERED | WS_EX_TRANSPARENT | WS_EX_TOOLWINDOW | WS_EX_TOPMOST | WS_EX_NOACTIVATE,
-        kClass, L"", WS_POPUP,
-        vs.left, vs.top, vs.right - vs.left, vs.bottom - vs.top,
-        nullptr, nullptr, hInstance, nullptr);
+    OverlayContext ctx;
+    ctx.hInstance = hInstance;
+    const MonitorLayout layout = EnumerateMonitors();
+
+    // Composition mode: one window over the whole desktop hosting the sprite visuals. Without
+    // Direct3D 11 or DirectComposition it falls back to layered windows.
+    HWND hwnd = nullptr;
+    if (gPresenterMode == PresenterMode::Composition)
+    {
+        hwnd = CreateOverlayWindow(ctx, kOverlayClass, layout.Bounds(), true);
+        if (hwnd)
+            ctx.visualBackend = CreateDCompBackend(hwnd);
+        if (ctx.visualBackend)
+        {
+            ctx.visuals = std::make_unique<SpriteVisualPresenter>(*ctx.visualBackend);
+        }
+        else
+        {
+            if (hwnd)
+                DestroyWindow(hwnd);
+            hwnd = nullptr;
+            gPresenterMode = PresenterMode::Layered;
+        }
+    }
+
+    // Otherwise the main transparent overlay window: the follow window, or the first display's overlay
+    if (!hwnd)
+    {
+        hwnd = CreateOverlayWindow(ctx, kOverlayClass,
+            gOverlayMode == OverlayMode::FullScreen && !layout.Empty() ? layout[0].rect : layout.Bounds());
+    }
     if (!hwnd)
     {
         CloseHandle(hMutex);
         return 0;
     }
 
-    // Make the window click-through
-    LONG_PTR ex = GetWindowLongPtr(hwnd, GWL_EXSTYLE);
-    ex |= WS_EX_LAYERED | WS_EX_TRANSPARENT | WS_EX_TOOLWINDOW | WS_EX_TOPMOST | WS_EX_NOACTIVATE;
-    SetWindowLongPtr(hwnd, GWL_EXSTYLE, ex);
-
-    SetWindowLongPtr(hwnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(&vs));
-    ShowWindow(hwnd, SW_SHOW);
-    UpdateWindow(hwnd);
-
-    // Exclude from desktop peek
-    BOOL exclude = TRUE;
-    DwmSetWindowAttribute(hwnd, DWMWA_EXCLUDED_FROM_PEEK, &exclude, sizeof(exclude));
+    // Initialize rendering resources; full-screen surfaces are allocated per display once the trail reaches it
+    ctx.hwnd = hwnd;
+    if (gOverlayMode == OverlayMode::FullScreen && !ctx.visuals)
+        ctx.monitorWindows.push_back(hwnd);
+    SyncMonitorWindows(ctx);
+    ctx.screenDC = GetDC(nullptr);
+    ctx.presentDC = GetDC(nullptr);
+    ctx.jobReady = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    ctx.slotReady = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+
+    // Accumulation keeps its history in one surface, so render and present take turns on it
+    const int slotCount = (gSettings.accumulate && gOverlayMode == OverlayMode::FullScreen) ? 1 : kFrameSlots;
+    for (int i = 0; i < slotCount; ++i)
+        ctx.freeSlots.TryPush(i);
+
+    // Large trails are stamped in tiles across a pool shared with the render thread
+    std::unique_ptr<WorkStealingPool> compositePool;
+    if (gCompositeThreads > 1)
+    {
+        compositePool = std::make_unique<WorkStealingPool>(gCompositeThreads);
+        ctx.renderer.SetPool(compositePool.get());
+    }
 
-    // Initialize rendering resources
-    HDC screenDC = GetDC(nullptr);
-    Backbuffer bb;
-    TempIconSurf tmp;
-    if (!bb.EnsureSize(screenDC, vs.right - vs.left, vs.bottom - vs.top))
+    // Without raw input the render thread falls back to polling the cursor once per frame,
+    // and a low-level mouse hook on this thread wakes it from idle
+    InputThread input;
+    input.wake = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    const bool rawInput = input.Start(hInstance);
+    HHOOK idleHook = nullptr;
+    if (!rawInput)
     {
-        ReleaseDC(nullptr, screenDC);
-        CloseHandle(hMutex);
-        return 0;
+        sHookInput = &input;
+        idleHook = SetWindowsHookExW(WH_MOUSE_LL, IdleMouseHook, hInstance, 0);
     }
+    input.canWake = input.wake && (rawInput || idleHook);
 
-    std::deque<Sample> trail;
-    CursorVisual cv{};
-    auto lastTick = std::chrono::steady_clock::now();
+    // Periodic JSON-lines stats; instrumentation stays disabled without it
+    StatsWriter statsWriter;
+    if (*gStatsPath)
+    {
+        std::FILE* statsFile = nullptr;
+        if (_wfopen_s(&statsFile, gStatsPath, L"w") == 0)
+            statsWriter.Start(statsFile, std::chrono::milliseconds(1000));
+    }
 
-    // Get maximum refresh rate
-    float maxHz = 60.f;
-    DISPLAY_DEVICE dd{};
-    dd.cb = sizeof(dd);
-    for (DWORD i = 0; EnumDisplayDevicesW(nullptr, i, &dd, 0); ++i)
+    // Cursor trace of every sample the trail sees, for replaying in the benchmarks
+    TraceRecorder recorder;
+    if (*gRecordPath)
     {
-        DEVMODE dm{};
-        dm.dmSize = sizeof(dm);
-        if (EnumDisplaySettingsW(dd.DeviceName, ENUM_CURRENT_SETTINGS, &dm))
-            maxHz = std::max(maxHz, static_cast<float>(dm.dmDisplayFrequency));
+        std::FILE* recordFile = nullptr;
+        if (_wfopen_s(&recordFile, gRecordPath, L"wb") == 0)
+            recorder.Start(recordFile, TrailClock::now());
     }
 
-    const auto frameInterval = std::chrono::milliseconds(
-        static_cast<int>(std::round(1000.0 / std::clamp(maxHz, 30.0f, 240.0f))));
+    std::thread presentThread([&ctx] { PresentLoop(ctx); });
+    std::thread renderThread([&] { RenderLoop(ctx, input, rawInput, recorder); });
 
-    // Main loop
+    // UI thread: pump messages until the overlay window is destroyed
     MSG msg{};
-    while (true)
+    while (GetMessageW(&msg, nullptr, 0, 0) > 0)
     {
-        while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
-        {
-            // Check if we need to quit the program
-            if (msg.message == WM_QUIT)
-            {
-                bb.Release();
-                tmp.Release();
-                ReleaseDC(nullptr, screenDC);
-                ReleaseTintCache();
-                CloseHandle(hMutex);
-                return 0;
-            }
-            TranslateMessage(&msg);
-            DispatchMessage(&msg);
-        }
-
-        std::this_thread::sleep_until(lastTick + frameInterval);
-        lastTick = std::chrono::steady_clock::now();
-
-        // Sample current cursor position
-        POINT cur{};
-        GetCursorPos(&cur);
-        UpdateTrail(trail, cur, lastTick);
-
-        // Check if screen size needs update
-        RECT curVS = GetVirtualScreenRect();
-        if (curVS.left != vs.left || curVS.top != vs.top ||
-            curVS.right != vs.right || curVS.bottom != vs.bottom)
-        {
-            vs = curVS;
-            SetWindowPos(hwnd, nullptr, vs.left, vs.top,
-                vs.right - vs.left, vs.bottom - vs.top,
-                SWP_NOZORDER | SWP_NOACTIVATE | SWP_NOSENDCHANGING);
-
-            if (!bb.EnsureSize(screenDC, vs.right - vs.left, vs.bottom - vs.top))
-            {
-                ReleaseTintCache();
-                ReleaseDC(nullptr, screenDC);
-                CloseHandle(hMutex);
-                return 0;
-            }
-        }
-
-        CURSORINFO ci{ sizeof(ci) };
-        if (!GetCursorInfo(&ci) || ci.flags != CURSOR_SHOWING || !ci.hCursor)
-        {
-            const auto now = std::chrono::steady_clock::now();
-            while (!trail.empty() &&
-                std::chrono::duration_cast<std::chrono::milliseconds>(now - trail.front().t).count() > (gTrailFadeMs + 50.f))
-                trail.pop_front();
-
-            if (!trail.empty())
-                DrawTrail(hwnd, screenDC, bb, tmp, cv, trail, vs);
-        }
-        else
-        {
-            RefreshCursorVisual(cv, ci);
-            DrawTrail(hwnd, screenDC, bb, tmp, cv, trail, vs);
-        }
+        TranslateMessage(&msg);
+        DispatchMessageW(&msg);
     }
+
+    ctx.quit.store(true, std::memory_order_release);
+    SetEvent(ctx.slotReady);
+    SetEvent(ctx.jobReady);
+    SetEvent(input.wake);
+    renderThread.join();
+    presentThread.join();
+    input.Stop();
+    if (idleHook)
+        UnhookWindowsHookEx(idleHook);
+    sHookInput = nullptr;
+    CloseHandle(input.wake);
+    statsWriter.Stop();
+    recorder.Stop();
+
+    ReportPresentStats(ctx);
+    for (size_t i = 1; i < ctx.monitorWindows.size(); ++i)
+        DestroyWindow(ctx.monitorWindows[i]);
+    ctx.Release();
+    ReleaseDC(nullptr, ctx.presentDC);
+    ReleaseDC(nullptr, ctx.screenDC);
+    CloseHandle(ctx.jobReady);
+    CloseHandle(ctx.slotReady);
+    ReleaseTintCache();
+    CloseHandle(hMutex);
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <d3d11.h>
+#include <dxgi.h>
+#include <dcomp.h>
+#include <wrl/client.h>
+#include <vector>
+#include "DCompPresenter.h"
+
+using Microsoft::WRL::ComPtr;
+
+// Sprite visuals as DirectComposition visuals under one root, all showing the same uploaded
+// surface. Each visual fades through its own effect group and shows one frame of an animated
+// sprite by clipping the frame's row out of the atlas.
+class DCompBackend final : public SpriteVisualBackend
+{
+public:
+    bool Init(HWND hwnd)
+    {
+        const D3D_DRIVER_TYPE drivers[] = { D3D_DRIVER_TYPE_HARDWARE, D3D_DRIVER_TYPE_WARP };
+        for (const D3D_DRIVER_TYPE driver : drivers)
+        {
+            if (SUCCEEDED(D3D11CreateDevice(nullptr, driver, nullptr, D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+                nullptr, 0, D3D11_SDK_VERSION, &d3d_, nullptr, &context_)))
+                break;
+        }
+
+        ComPtr<IDXGIDevice> dxgi;
+        return d3d_ && SUCCEEDED(d3d_.As(&dxgi)) &&
+            SUCCEEDED(DCompositionCreateDevice(dxgi.Get(), __uuidof(IDCompositionDevice),
+                reinterpret_cast<void**>(device_.GetAddressOf()))) &&
+            SUCCEEDED(device_->CreateTargetForHwnd(hwnd, TRUE, &target_)) &&
+            SUCCEEDED(device_->CreateVisual(&root_)) &&
+            SUCCEEDED(target_->SetRoot(root_.Get())) &&
+            SUCCEEDED(device_->Commit());
+    }
+
+    bool SetSprite(const Sprite& sprite) override
+    {
+        const UINT w = static_cast<UINT>(sprite.w);
+        const UINT h = static_cast<UINT>(sprite.h * sprite.frames);
+        ComPtr<IDCompositionSurface> surface;
+        if (FAILED(device_->CreateSurface(w, h, DXGI_FORMAT_B8G8R8A8_UNORM, DXGI_ALPHA_MODE_PREMULTIPLIED, &surface)))
+            return false;
+
+        // The surface may be placed anywhere in a shared atlas texture
+        ComPtr<ID3D11Texture2D> texture;
+        POINT offset{};
+        if (FAILED(surface->BeginDraw(nullptr, __uuidof(ID3D11Texture2D),
+            reinterpret_cast<void**>(texture.GetAddressOf()), &offset)))
+            return false;
+        const D3D11_BOX box{ static_cast<UINT>(offset.x), static_cast<UINT>(offset.y), 0,
+            static_cast<UINT>(offset.x) + w, static_cast<UINT>(offset.y) + h, 1 };
+        context_->UpdateSubresource(texture.Get(), 0, &box, sprite.px.data(), w * sizeof(uint32_t), 0);
+        if (FAILED(surface->EndDraw()))
+            return false;
+
+        surface_ = surface;
+        spriteW_ = sprite.w;
+        spriteH_ = sprite.h;
+        for (Instance& v : visuals_)
+        {
+            v.visual->SetContent(surface_.Get());
+            v.frame = -1;
+        }
+        return true;
+    }
+
+    size_t Reserve(size_t count) override
+    {
+        while (visuals_.size() < count)
+        {
+            Instance v;
+            if (FAILED(device_->CreateVisual(&v.visual)) || FAILED(device_->CreateEffectGroup(&v.effect)))
+                break;
+            v.effect->SetOpacity(0.f);
+            v.visual->SetEffect(v.effect.Get());
+            v.visual->SetContent(surface_.Get());
+
+            // Above every visual added before it, so stamps stack oldest to newest
+            if (FAILED(root_->AddVisual(v.visual.Get(), TRUE, nullptr)))
+                break;
+            visuals_.push_back(std::move(v));
+        }
+        return visuals_.size();
+    }
+
+    void Place(size_t i, int x, int y, uint8_t alpha, int frame) override
+    {
+        Instance& v = visuals_[i];
+        v.visual->SetOffsetX(static_cast<float>(x));
+        v.visual->SetOffsetY(static_cast<float>(y - frame * spriteH_));
+        if (v.frame != frame)
+        {
+            const D2D_RECT_F clip{ 0.f, static_cast<float>(frame * spriteH_),
+                static_cast<float>(spriteW_), static_cast<float>((frame + 1) * spriteH_) };
+            v.visual->SetClip(clip);
+            v.frame = frame;
+        }
+        v.effect->SetOpacity(static_cast<float>(alpha) / 255.f);
+    }
+
+    void Hide(size_t i) override
+    {
+        visuals_[i].effect->SetOpacity(0.f);
+    }
+
+    void Commit() override
+    {
+        device_->Commit();
+    }
+
+private:
+    struct Instance
+    {
+        ComPtr<IDCompositionVisual> visual;
+        ComPtr<IDCompositionEffectGroup> effect;
+        int frame = -1; // Frame the clip shows, -1 until clipped for the current sprite
+    };
+
+    ComPtr<ID3D11Device> d3d_;
+    ComPtr<ID3D11DeviceContext> context_;
+    ComPtr<IDCompositionDevice> device_;
+    ComPtr<IDCompositionTarget> target_;
+    ComPtr<IDCompositionVisual> root_;
+    ComPtr<IDCompositionSurface> surface_;
+    std::vector<Instance> visuals_;
+    int spriteW_ = 0, spriteH_ = 0;
+};
+
+std::unique_ptr<SpriteVisualBackend> CreateDCompBackend(HWND hwnd)
+{
+    auto backend = std::make_unique<DCompBackend>();
+    if (!backend->Init(hwnd))
+        return nullptr;
+    return backend;
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <windows.h>
+#include <memory>
+#include "Core/Presenter.h"
+
+// Creates a DirectComposition backend whose sprite visuals are composed into hwnd, which must
+// have been created with WS_EX_NOREDIRECTIONBITMAP. Returns nullptr when Direct3D 11 or
+// DirectComposition is unavailable, so the caller can fall back to layered windows.
+std::unique_ptr<SpriteVisualBackend> CreateDCompBackend(HWND hwnd);
@@ -0,0 +1,80 @@
+#include "Tests/Test.h"
+#include "Core/Blend.h"
+#include <random>
+#include <vector>
+
+// Random premultiplied pixel, or an arbitrary one to exercise saturation
+static uint32_t RandomPixel(std::mt19937& rng, bool premultiplied)
+{
+    const uint32_t a = rng() & 0xFF;
+    const uint32_t lim = premultiplied ? a : 255;
+    const uint32_t b = lim ? rng() % (lim + 1) : 0;
+    const uint32_t g = lim ? rng() % (lim + 1) : 0;
+    const uint32_t r = lim ? rng() % (lim + 1) : 0;
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+static void CheckKernelMatchesScalar(BlendKernel kernel)
+{
+    const BlendRowFn fn = GetBlendRow(kernel);
+    if (!fn)
+        return; // Not available on this machine
+
+    std::mt19937 rng(1234);
+    for (bool premul : { true, false })
+    {
+        for (int count = 0; count <= 67; ++count)
+        {
+            for (uint32_t alpha : { 0u, 1u, 3u, 10u, 127u, 128u, 254u, 255u })
+            {
+                std::vector<uint32_t> src(count), ref(count);
+                for (int i = 0; i < count; ++i)
+                {
+                    src[i] = RandomPixel(rng, premul);
+                    ref[i] = RandomPixel(rng, premul);
+                }
+                std::vector<uint32_t> out = ref;
+
+                BlendRowScalar(ref.data(), src.data(), count, alpha);
+                fn(out.data(), src.data(), count, alpha);
+                for (int i = 0; i < count; ++i)
+                    CHECK_EQ(out[i], ref[i]);
+            }
+        }
+    }
+}
+
+TEST(Blend, ScalarEdgeValues)
+{
+    uint32_t d[3] = { 0xFF000000u, 0x00000000u, 0xFFFFFFFFu };
+    const uint32_t s[3] = { 0xFFFFFFFFu, 0x00FFFFFFu, 0x00000000u };
+
+    BlendRowScalar(d, s, 3, 255);
+    CHECK_EQ(d[0], 0xFFFFFFFFu);
+    CHECK_EQ(d[1], 0x00FFFFFFu); // Zero-alpha source adds color
+    CHECK_EQ(d[2], 0xFFFFFFFFu);
+}
+
+TEST(Blend, SSE2MatchesScalar)
+{
+    CheckKernelMatchesScalar(BlendKernel::SSE2);
+}
+
+TEST(Blend, AVX2MatchesScalar)
+{
+    CheckKernelMatchesScalar(BlendKernel::AVX2);
+}
+
+TEST(Blend, NEONMatchesScalar)
+{
+    CheckKernelMatchesScalar(BlendKernel::NEON);
+}
+
+TEST(Blend, ActiveKernelSelectable)
+{
+    const BlendKernel best = ActiveBlendKernel();
+    CHECK(GetBlendRow(best) != nullptr);
+    CHECK(SetActiveBlendKernel(BlendKernel::Scalar));
+    CHECK(ActiveBlendRow() == &BlendRowScalar);
+    CHECK(SetActiveBlendKernel(best));
+}
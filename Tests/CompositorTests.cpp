@@ -0,0 +1,267 @@
+#include "Tests/Test.h"
+#include "Core/Compositor.h"
+#include "Core/TrailStepper.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std::chrono_literals;
+
+static Sprite MakeSolidSprite(int w, int h, uint32_t color)
+{
+    Sprite s;
+    s.w = w;
+    s.h = h;
+    s.px.assign(static_cast<size_t>(w) * h, color);
+    return s;
+}
+
+TEST(Compositor, TintScalesColorChannels)
+{
+    uint32_t px[2] = { 0xFFFFFFFFu, 0x80804020u };
+    TintPixels(px, 2, 255, 128, 0);
+    CHECK_EQ(px[0], 0xFFFF8000u);
+    CHECK_EQ(px[1], 0x80802000u);
+}
+
+TEST(Compositor, BlendOpaqueSpriteFullAlpha)
+{
+    PixelBuffer buf;
+    buf.Resize(4, 4);
+    const Sprite s = MakeSolidSprite(2, 2, 0xFF336699u);
+
+    const uint64_t n = BlendSprite(buf.View(), s, 1, 1, 255);
+    CHECK_EQ(n, uint64_t(4));
+    CHECK_EQ(buf.px[0], 0u);
+    CHECK_EQ(buf.px[1 * 4 + 1], 0xFF336699u);
+    CHECK_EQ(buf.px[2 * 4 + 2], 0xFF336699u);
+}
+
+TEST(Compositor, BlendMatchesSourceOverFormula)
+{
+    PixelBuffer buf;
+    buf.Resize(1, 1);
+    buf.px[0] = 0xFF204060u;
+    const Sprite s = MakeSolidSprite(1, 1, 0x80404040u);
+
+    // a' = 128*128/255 = 64; c = 64*128/255 + d*(255-64)/255
+    BlendSprite(buf.View(), s, 0, 0, 128);
+    CHECK_EQ(buf.px[0], 0xFF385068u);
+}
+
+TEST(Compositor, BlendClipsAgainstEdges)
+{
+    PixelBuffer buf;
+    buf.Resize(3, 3);
+    const Sprite s = MakeSolidSprite(4, 4, 0xFFFFFFFFu);
+
+    CHECK_EQ(BlendSprite(buf.View(), s, -2, -2, 255), uint64_t(4));
+    CHECK_EQ(BlendSprite(buf.View(), s, 3, 0, 255), uint64_t(0));
+    CHECK_EQ(buf.px[0], 0xFFFFFFFFu);
+    CHECK_EQ(buf.px[2], 0u);
+}
+
+TEST(Compositor, RenderTrailStampsAlongSegment)
+{
+    PixelBuffer buf;
+    buf.Resize(64, 16);
+    Sprite s = MakeSolidSprite(2, 2, 0xFFFFFFFFu);
+
+    TrailSettings settings;
+    settings.maxAlpha = 255;
+    settings.sensitivity = 1.f;
+
+    const auto now = TrailClock::time_point{} + 100ms;
+    TrailBuffer trail;
+    trail.Push({ 40, 8 }, now - 5ms);
+    trail.Push({ 10, 8 }, now - 10ms);
+
+    const TrailRenderStats stats = RenderTrail(buf.View(), s, trail, 0, 0, now, settings);
+    CHECK_EQ(stats.stamps, 31);
+    CHECK(buf.px[8 * 64 + 10] != 0u);
+    CHECK(buf.px[8 * 64 + 41] != 0u);
+    CHECK_EQ(buf.px[8 * 64 + 50], 0u);
+    CHECK_EQ(buf.px[2 * 64 + 20], 0u);
+
+    CHECK_EQ(stats.bounds.left, 10);
+    CHECK_EQ(stats.bounds.top, 8);
+    CHECK_EQ(stats.bounds.right, 42);
+    CHECK_EQ(stats.bounds.bottom, 10);
+}
+
+// Two stacked frames: red for the first 10ms of each 20ms cycle, blue for the rest
+static Sprite MakeTwoFrameSprite(int w, int h)
+{
+    Sprite s = MakeSolidSprite(w, h * 2, 0xFFFF0000u);
+    s.h = h;
+    std::fill(s.px.begin() + static_cast<ptrdiff_t>(w) * h, s.px.end(), 0xFF0000FFu);
+    s.frames = 2;
+    s.frameEndUs = { 10000, 20000 };
+    return s;
+}
+
+TEST(Compositor, FrameAtCyclesThroughFrames)
+{
+    const Sprite s = MakeTwoFrameSprite(2, 2);
+    CHECK(s.Animated());
+    CHECK_EQ(s.FrameAt(0), 0);
+    CHECK_EQ(s.FrameAt(9999), 0);
+    CHECK_EQ(s.FrameAt(10000), 1);
+    CHECK_EQ(s.FrameAt(25000), 0);
+    CHECK_EQ(s.FrameAt(-1), 1);
+    CHECK_EQ(s.FramePixels(1)[0], 0xFF0000FFu);
+
+    const Sprite still = MakeSolidSprite(2, 2, 0xFFFFFFFFu);
+    CHECK(!still.Animated());
+    CHECK_EQ(still.FrameAt(15000), 0);
+}
+
+TEST(Compositor, RenderTrailPicksFramePerStamp)
+{
+    PixelBuffer buf;
+    buf.Resize(64, 16);
+    const Sprite s = MakeTwoFrameSprite(2, 2);
+
+    TrailSettings settings;
+    settings.maxAlpha = 255;
+    settings.sensitivity = 1.f;
+
+    // The segment spans 85ms..95ms, crossing the frame change at 90ms halfway along
+    const auto now = TrailClock::time_point{} + 100ms;
+    TrailBuffer trail;
+    trail.Push({ 40, 8 }, now - 5ms);
+    trail.Push({ 10, 8 }, now - 15ms);
+
+    RenderTrail(buf.View(), s, trail, 0, 0, now, settings);
+    const uint32_t start = buf.px[8 * 64 + 10];
+    const uint32_t end = buf.px[8 * 64 + 41];
+    CHECK(((start >> 16) & 0xFF) > (start & 0xFF));
+    CHECK((end & 0xFF) > ((end >> 16) & 0xFF));
+}
+
+// Slow drag, one pixel per millisecond sample; every segment starts where the previous one ended
+static TrailBuffer MakeSlowTrail(TrailClock::time_point now)
+{
+    TrailBuffer trail;
+    for (int i = 30; i >= 0; --i)
+        trail.Push({ 20 + (30 - i), 20 + (30 - i) / 3 }, now - std::chrono::milliseconds(i));
+    return trail;
+}
+
+TEST(Compositor, CoalescingMergesStampsAtSamePosition)
+{
+    const auto now = TrailClock::time_point{} + 1s;
+    const TrailBuffer trail = MakeSlowTrail(now);
+    TrailSettings settings;
+    settings.maxAlpha = 120;
+    settings.sensitivity = 0.2f;
+    TrailAlphaLut lut;
+    lut.Update(settings);
+
+    std::vector<SpriteStamp> plain, merged;
+    int removed = -1;
+    CollectStamps(MakeSolidSprite(6, 6, 0xFFFFFFFFu), trail, now, settings, lut, plain, &removed);
+    CHECK_EQ(removed, 0);
+    settings.coalesce = true;
+    CollectStamps(MakeSolidSprite(6, 6, 0xFFFFFFFFu), trail, now, settings, lut, merged, &removed);
+
+    // Segment ends meet at every sample, so at least one stamp per sample folds away
+    CHECK(merged.size() + 30 <= plain.size());
+    CHECK_EQ(merged.size() + static_cast<size_t>(removed), plain.size());
+
+    // Each run of equal positions becomes one stamp of alpha 1 - prod(1 - a)
+    size_t i = 0;
+    for (const SpriteStamp& m : merged)
+    {
+        CHECK(i < plain.size());
+        float keep = 255.f;
+        for (; i < plain.size() && plain[i].x == m.x && plain[i].y == m.y; ++i)
+            keep *= static_cast<float>(255 - plain[i].alpha) / 255.f;
+        CHECK_EQ(static_cast<int>(m.alpha), 255 - static_cast<int>(keep + 0.5f));
+    }
+    CHECK_EQ(i, plain.size());
+}
+
+TEST(Compositor, CoalescedRenderMatchesSequentialForOpaqueSprite)
+{
+    const auto now = TrailClock::time_point{} + 1s;
+    const TrailBuffer trail = MakeSlowTrail(now);
+    const Sprite sprite = MakeSolidSprite(8, 8, 0xFFC08040u);
+    TrailSettings settings;
+    settings.maxAlpha = 90;
+    settings.sensitivity = 0.2f;
+
+    PixelBuffer a, b;
+    a.Resize(80, 60);
+    b.Resize(80, 60);
+    const TrailRenderStats plain = RenderTrail(a.View(), sprite, trail, 0, 0, now, settings);
+    settings.coalesce = true;
+    const TrailRenderStats merged = RenderTrail(b.View(), sprite, trail, 0, 0, now, settings);
+    CHECK(merged.stamps < plain.stamps);
+    CHECK_EQ(merged.stamps + merged.stampsCoalesced, plain.stamps);
+    CHECK(merged.pixelsBlended < plain.pixelsBlended);
+
+    // Only 8-bit rounding differs, which sequential blending accumulates over dozens of overlapping stamps
+    int worst = 0;
+    for (size_t i = 0; i < a.px.size(); ++i)
+    {
+        for (int c = 0; c < 32; c += 8)
+            worst = std::max(worst, std::abs(static_cast<int>((a.px[i] >> c) & 0xFF) - static_cast<int>((b.px[i] >> c) & 0xFF)));
+    }
+    CHECK(worst <= 4);
+}
+
+TEST(Compositor, CullDropsFaintStampsAfterMerging)
+{
+    const auto now = TrailClock::time_point{} + 1s;
+    const TrailBuffer trail = MakeSlowTrail(now);
+    const Sprite sprite = MakeSolidSprite(4, 4, 0xFFFFFFFFu);
+    TrailSettings settings;
+    settings.maxAlpha = 60;
+    settings.sensitivity = 0.2f;
+    settings.coalesce = true;
+    TrailAlphaLut lut;
+    lut.Update(settings);
+
+    std::vector<SpriteStamp> all, kept;
+    CollectStamps(sprite, trail, now, settings, lut, all);
+    settings.cullAlpha = 20;
+    int removed = 0;
+    CollectStamps(sprite, trail, now, settings, lut, kept, &removed);
+
+    size_t faint = 0;
+    for (const SpriteStamp& s : all)
+        faint += s.alpha < 20;
+    CHECK(faint > 0);
+    CHECK_EQ(kept.size(), all.size() - faint);
+    for (const SpriteStamp& s : kept)
+        CHECK(s.alpha >= 20);
+}
+
+TEST(Compositor, ErrorBudgetWidensFaintStepsWithinBudget)
+{
+    const auto now = TrailClock::time_point{} + 1s;
+    TrailBuffer trail;
+    for (int i = 20; i >= 0; --i)
+        trail.Push({ 20 + (20 - i) * 9, 40 + (20 - i) * 3 }, now - std::chrono::milliseconds(2 * i));
+    const Sprite sprite = MakeSolidSprite(16, 16, 0xFFFFFFFFu);
+    TrailSettings settings;
+    settings.maxAlpha = 12;
+    settings.sensitivity = 0.1f;
+    settings.fadeMs = 50.f;
+
+    PixelBuffer a, b;
+    a.Resize(240, 120);
+    b.Resize(240, 120);
+    const TrailRenderStats plain = RenderTrail(a.View(), sprite, trail, 0, 0, now, settings);
+    settings.errorBudget = 24;
+    const TrailRenderStats wide = RenderTrail(b.View(), sprite, trail, 0, 0, now, settings);
+    CHECK(wide.stamps * 2 < plain.stamps);
+    CHECK_EQ(wide.bounds.left, plain.bounds.left);
+    CHECK_EQ(wide.bounds.right, plain.bounds.right);
+
+    // Differences stay within a stamp of the budget where the wider steps band across the cursor's edge
+    int worst = 0;
+    for (size_t i = 0; i < a.px.size(); ++i)
+        worst = std::max(worst, std::abs(static_cast<int>(a.px[i] >> 24) - static_cast<int>(b.px[i] >> 24)));
+    CHECK(worst <= settings.errorBudget);
+}
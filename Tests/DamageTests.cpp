@@ -0,0 +1,92 @@
+#include "Tests/Test.h"
+#include "Core/Damage.h"
+#include "Core/Compositor.h"
+
+TEST(Damage, FirstFrameIsFullSurface)
+{
+    DamageTracker damage;
+    const PixelRect clear = damage.PendingClear(100, 50);
+    CHECK_EQ(clear.Area(), uint64_t(5000));
+
+    const FrameDamage fd = damage.EndFrame({ 10, 10, 20, 20 }, 100, 50);
+    CHECK_EQ(fd.damagedPixels, uint64_t(5000));
+    CHECK_EQ(fd.surfacePixels, uint64_t(5000));
+}
+
+TEST(Damage, PresentsUnionOfPreviousAndCurrent)
+{
+    DamageTracker damage;
+    damage.EndFrame({ 10, 10, 20, 20 }, 100, 50);
+
+    const PixelRect clear = damage.PendingClear(100, 50);
+    CHECK_EQ(clear.left, 10);
+    CHECK_EQ(clear.bottom, 20);
+
+    const FrameDamage fd = damage.EndFrame({ 30, 15, 40, 25 }, 100, 50);
+    CHECK_EQ(fd.present.left, 10);
+    CHECK_EQ(fd.present.top, 10);
+    CHECK_EQ(fd.present.right, 40);
+    CHECK_EQ(fd.present.bottom, 25);
+    CHECK_EQ(fd.damagedPixels, uint64_t(30 * 15));
+    CHECK_EQ(damage.Frames(), uint64_t(2));
+    CHECK_EQ(damage.TotalSurfacePixels(), uint64_t(10000));
+}
+
+TEST(Damage, IdleFramesHaveNoDamage)
+{
+    DamageTracker damage;
+    damage.EndFrame({ 0, 0, 5, 5 }, 100, 50);
+    damage.EndFrame({}, 100, 50); // Trail faded: erase last stamps
+
+    const FrameDamage fd = damage.EndFrame({}, 100, 50);
+    CHECK(fd.present.Empty());
+    CHECK(damage.PendingClear(100, 50).Empty());
+}
+
+TEST(Damage, InvalidateForcesFullFrame)
+{
+    DamageTracker damage;
+    damage.EndFrame({ 0, 0, 5, 5 }, 100, 50);
+    damage.Invalidate();
+    CHECK_EQ(damage.PendingClear(200, 50).Area(), uint64_t(10000));
+    CHECK_EQ(damage.EndFrame({}, 200, 50).damagedPixels, uint64_t(10000));
+}
+
+TEST(Damage, ClearRectOnlyTouchesRegion)
+{
+    PixelBuffer buf;
+    buf.Resize(8, 8);
+    buf.px.assign(buf.px.size(), 0xFFFFFFFFu);
+
+    ClearRect(buf.View(), { 2, 2, 4, 4 });
+    CHECK_EQ(buf.px[2 * 8 + 2], 0u);
+    CHECK_EQ(buf.px[3 * 8 + 3], 0u);
+    CHECK_EQ(buf.px[4 * 8 + 4], 0xFFFFFFFFu);
+    CHECK_EQ(buf.px[1 * 8 + 2], 0xFFFFFFFFu);
+
+    ClearRect(buf.View(), { -5, -5, 1, 100 }); // Clipped
+    CHECK_EQ(buf.px[7 * 8 + 0], 0u);
+}
+
+TEST(Damage, DoubleBufferClearsEachSurfaceHistory)
+{
+    DamageTracker damage(2);
+    CHECK_EQ(damage.Buffers(), 2);
+    damage.EndFrame({ 0, 0, 10, 10 }, 100, 50, 0);
+
+    // Buffer 1 has never been drawn, so it still needs a full clear
+    CHECK_EQ(damage.PendingClear(100, 50, 1).Area(), uint64_t(5000));
+    const FrameDamage second = damage.EndFrame({ 20, 0, 30, 10 }, 100, 50, 1);
+    CHECK_EQ(second.present.left, 0); // Relative to buffer 0's frame on screen
+    CHECK_EQ(second.present.right, 30);
+
+    // Buffer 0 still holds its own frame from two frames ago
+    const PixelRect clear0 = damage.PendingClear(100, 50, 0);
+    CHECK_EQ(clear0.left, 0);
+    CHECK_EQ(clear0.right, 10);
+
+    const FrameDamage third = damage.EndFrame({ 40, 0, 50, 10 }, 100, 50, 0);
+    CHECK_EQ(third.present.left, 20);
+    CHECK_EQ(third.present.right, 50);
+    CHECK_EQ(damage.PendingClear(100, 50, 1).left, 20);
+}
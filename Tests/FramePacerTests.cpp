@@ -0,0 +1,88 @@
+#include "Tests/Test.h"
+#include "Core/FramePacer.h"
+
+using namespace std::chrono_literals;
+
+TEST(FramePacer, PeriodKeepsSubMillisecondPrecision)
+{
+    const FramePacer pacer(144.0);
+    CHECK_EQ(std::chrono::duration_cast<std::chrono::nanoseconds>(pacer.Period()).count(), int64_t(6944444));
+
+    CHECK_EQ(FramePacer(10.0).Rate(), kMinFrameRateHz);
+    CHECK_EQ(FramePacer(1000.0).Rate(), kMaxFrameRateHz);
+}
+
+TEST(FramePacer, DeadlinesDoNotDriftWithLateWakeups)
+{
+    FramePacer pacer(144.0);
+    const auto start = TrailClock::time_point{} + 1s;
+    auto now = start;
+    CHECK(pacer.Deadline(now) == start);
+
+    // Every wakeup lands 300us late; the schedule stays on the 144 Hz grid regardless
+    for (int i = 0; i < 144; ++i)
+    {
+        now = pacer.Deadline(now) + 300us;
+        CHECK_EQ(pacer.FrameStarted(now), 0);
+    }
+
+    const auto drift = pacer.Deadline(now) - (start + 1s);
+    CHECK(drift > -1us && drift < 1us);
+}
+
+TEST(FramePacer, OverrunSkipsMissedDeadlines)
+{
+    FramePacer pacer(100.0);
+    const auto start = TrailClock::time_point{} + 1s;
+    pacer.FrameStarted(start);
+    CHECK(pacer.Deadline(start) == start + 10ms);
+
+    // A frame starting 35ms late resumes on the grid instead of running the missed frames back to back
+    CHECK_EQ(pacer.FrameStarted(start + 45ms), 3);
+    CHECK(pacer.Deadline(start + 45ms) == start + 50ms);
+}
+
+TEST(FramePacer, RateChangeKeepsScheduledDeadline)
+{
+    FramePacer pacer(60.0);
+    const auto start = TrailClock::time_point{} + 1s;
+    pacer.FrameStarted(start);
+    const auto scheduled = pacer.Deadline(start);
+
+    pacer.SetRate(240.0);
+    CHECK(pacer.Deadline(start) == scheduled);
+    pacer.FrameStarted(scheduled);
+    CHECK(pacer.Deadline(scheduled) - scheduled == pacer.Period());
+}
+
+TEST(VsyncScheduler, LeadFollowsSlowestRecentFrame)
+{
+    VsyncScheduler sched;
+    const auto period = std::chrono::nanoseconds(16666667);
+    CHECK(sched.Lead(period) == period / 2);
+
+    sched.AddFrameCost(1ms);
+    sched.AddFrameCost(3ms);
+    sched.AddFrameCost(2ms);
+    CHECK(sched.Lead(period) == TrailClock::duration(3ms + VsyncScheduler::kMargin));
+
+    // The slow frame ages out of the window
+    for (size_t i = 0; i < VsyncScheduler::kHistory; ++i)
+        sched.AddFrameCost(1ms);
+    CHECK(sched.Lead(period) == TrailClock::duration(1ms + VsyncScheduler::kMargin));
+
+    // Never more than 3/4 of the period
+    sched.AddFrameCost(50ms);
+    CHECK(sched.Lead(period) == period * 3 / 4);
+}
+
+TEST(VsyncScheduler, WakesJustBeforeVBlank)
+{
+    VsyncScheduler sched;
+    sched.AddFrameCost(2ms);
+    const auto period = std::chrono::nanoseconds(6944444);
+    const auto now = TrailClock::time_point{} + 1s;
+
+    CHECK(sched.WakeTime(now, now + 6ms, period) == now + 6ms - 2ms - VsyncScheduler::kMargin);
+    CHECK(sched.WakeTime(now, now + 1ms, period) == now); // Already inside the lead: start right away
+}
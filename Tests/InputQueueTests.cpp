@@ -0,0 +1,110 @@
+#include "Tests/Test.h"
+#include "Core/TraceInput.h"
+
+using namespace std::chrono_literals;
+
+TEST(InputQueue, FillsWrapsAndPreservesOrder)
+{
+    SpscQueue<int, 8> q;
+    int v = 0;
+    CHECK(!q.TryPop(v));
+
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 0; i < 8; ++i)
+            CHECK(q.TryPush(round * 100 + i));
+        CHECK(!q.TryPush(-1));
+        CHECK_EQ(q.SizeApprox(), size_t(8));
+
+        for (int i = 0; i < 5; ++i)
+        {
+            CHECK(q.TryPop(v));
+            CHECK_EQ(v, round * 100 + i);
+        }
+
+        int next = round * 100 + 5;
+        bool ordered = true;
+        CHECK_EQ(q.PopAll([&](int x) { ordered = ordered && x == next++; }), size_t(3));
+        CHECK(ordered);
+        CHECK_EQ(q.SizeApprox(), size_t(0));
+    }
+}
+
+TEST(InputQueue, ConcurrentProducerConsumer)
+{
+    constexpr int kCount = 200000;
+    SpscQueue<int, 64> q;
+    std::thread producer([&]
+    {
+        for (int i = 0; i < kCount; ++i)
+            while (!q.TryPush(i))
+                std::this_thread::yield();
+    });
+
+    int expected = 0;
+    bool ordered = true;
+    while (expected < kCount)
+    {
+        if (q.PopAll([&](int x) { ordered = ordered && x == expected++; }) == 0)
+            std::this_thread::yield();
+    }
+    producer.join();
+    CHECK(ordered);
+    CHECK_EQ(expected, kCount);
+}
+
+TEST(InputQueue, DrainKeepsSampleTimestamps)
+{
+    TrailSettings settings;
+    const auto t0 = TrailClock::time_point{} + 1s;
+    InputQueue q;
+    q.TryPush({ { 0, 0 }, t0 });
+    q.TryPush({ { 0, 0 }, t0 + 1ms }); // Did not move
+    q.TryPush({ { 5, 0 }, t0 + 2ms });
+    q.TryPush({ { 9, 3 }, t0 + 3ms });
+
+    TrailBuffer trail;
+    CHECK_EQ(DrainInput(q, trail, t0 + 4ms, settings), size_t(4));
+    CHECK_EQ(trail.Size(), size_t(3));
+    CHECK_EQ(trail.TimeUs(2) - trail.TimeUs(1), 1000);
+    CHECK_EQ(trail.Back().x, 9);
+
+    // Everything is past fade + 50 ms by now
+    CHECK_EQ(DrainInput(q, trail, t0 + 200ms, settings), size_t(0));
+    CHECK(trail.Empty());
+}
+
+TEST(InputQueue, TraceReplayFeedsTrail)
+{
+    std::vector<TraceSample> trace;
+    for (int i = 0; i < 600; ++i)
+        trace.push_back({ i * 1000, { i, i / 2 } });
+
+    // 20x speed: 600 ms of 1000 Hz input in about 30 ms, drained by a 1 ms "frame loop"
+    TrailSettings settings;
+    settings.fadeMs = 1000.f;
+    TrailBuffer trail(1000);
+    InputQueue q;
+    TraceInputThread replay;
+    replay.Start(trace, q, TrailClock::now(), 20.0);
+
+    size_t consumed = 0;
+    while (!replay.Done())
+    {
+        consumed += DrainInput(q, trail, TrailClock::now(), settings);
+        std::this_thread::sleep_for(1ms);
+    }
+    replay.Stop();
+    consumed += DrainInput(q, trail, TrailClock::now(), settings);
+
+    CHECK_EQ(replay.Pushed() + replay.Dropped(), uint64_t(600));
+    CHECK_EQ(replay.Dropped(), uint64_t(0));
+    CHECK_EQ(consumed, size_t(600));
+    CHECK_EQ(trail.Size(), size_t(600));
+    CHECK_EQ(trail.Back().x, 599);
+
+    bool increasing = true;
+    for (size_t i = 1; i < trail.Size(); ++i)
+        increasing = increasing && trail.TimeUs(i) > trail.TimeUs(i - 1);
+    CHECK(increasing);
+}
@@ -0,0 +1,63 @@
+#include "Tests/Test.h"
+#include "Core/MonitorLayout.h"
+
+// 2560x1440 at 150% with a 1920x1080 at 100% to its right, bottom-aligned
+static MonitorLayout MixedLayout()
+{
+    return MonitorLayout({ { { 0, 0, 2560, 1440 }, 144 }, { { 2560, 360, 4480, 1440 }, 96 } });
+}
+
+TEST(MonitorLayout, BoundsAndCoveredPixels)
+{
+    const MonitorLayout layout = MixedLayout();
+    CHECK_EQ(layout.Size(), size_t(2));
+
+    const PixelRect bounds = layout.Bounds();
+    CHECK_EQ(bounds.left, 0);
+    CHECK_EQ(bounds.top, 0);
+    CHECK_EQ(bounds.right, 4480);
+    CHECK_EQ(bounds.bottom, 1440);
+
+    // The dead band above the smaller display is part of the virtual screen only
+    CHECK_EQ(layout.CoveredPixels(), uint64_t(2560 * 1440 + 1920 * 1080));
+    CHECK_EQ(bounds.Area() - layout.CoveredPixels(), uint64_t(1920 * 360));
+}
+
+TEST(MonitorLayout, IndexAtFallsBackToNearest)
+{
+    const MonitorLayout layout = MixedLayout();
+    CHECK_EQ(layout.IndexAt(100, 100), 0);
+    CHECK_EQ(layout.IndexAt(2559, 1439), 0);
+    CHECK_EQ(layout.IndexAt(2560, 1439), 1);
+    CHECK_EQ(layout.IndexAt(3000, 100), 1); // Dead band, closest to the right display
+    CHECK_EQ(layout.IndexAt(-50, 700), 0);
+    CHECK_EQ(MonitorLayout().IndexAt(0, 0), -1);
+}
+
+TEST(MonitorLayout, DropsEmptyAndExtraDisplays)
+{
+    std::vector<MonitorArea> areas(kMaxMonitors + 4);
+    for (size_t i = 0; i < areas.size(); ++i)
+        areas[i].rect = { static_cast<int>(i) * 100, 0, static_cast<int>(i) * 100 + 100, 100 };
+    areas[1].rect = {};
+
+    const MonitorLayout layout(areas);
+    CHECK_EQ(layout.Size(), kMaxMonitors);
+    CHECK_EQ(layout[1].rect.left, 200);
+    CHECK(layout != MixedLayout());
+    CHECK(MixedLayout() == MixedLayout());
+
+    // A refresh rate change alone is a new layout
+    std::vector<MonitorArea> faster{ { { 0, 0, 2560, 1440 }, 144, 165.0 }, { { 2560, 360, 4480, 1440 }, 96 } };
+    CHECK(MonitorLayout(faster) != MixedLayout());
+}
+
+TEST(MonitorLayout, ScaleForDpi)
+{
+    CHECK_EQ(ScaleForDpi(32, 96), 32);
+    CHECK_EQ(ScaleForDpi(32, 144), 48);
+    CHECK_EQ(ScaleForDpi(32, 120), 40);
+    CHECK_EQ(ScaleForDpi(48, 96, 144), 32);
+    CHECK_EQ(ScaleForDpi(1, 48), 1);
+    CHECK_EQ(ScaleForDpi(0, 144), 0);
+}
@@ -0,0 +1,279 @@
+#include "Tests/Test.h"
+#include "Core/Presenter.h"
+
+using namespace std::chrono_literals;
+
+static Sprite MakePresenterSprite()
+{
+    Sprite s;
+    s.w = 10;
+    s.h = 8;
+    s.hotX = 3;
+    s.hotY = 2;
+    s.px.resize(static_cast<size_t>(s.w) * s.h);
+    for (size_t i = 0; i < s.px.size(); ++i)
+    {
+        const uint32_t a = static_cast<uint32_t>(90 + (i * 7) % 160);
+        s.px[i] = (a << 24) | ((a / 2) << 16) | (a << 8) | (a / 3);
+    }
+    return s;
+}
+
+static TrailSettings PresenterSettings()
+{
+    TrailSettings settings;
+    settings.maxAlpha = 200;
+    settings.sensitivity = 0.05f;
+    settings.fadeMs = 100.f;
+    return settings;
+}
+
+static const TrailClock::time_point kPresentNow = TrailClock::time_point{} + 1s;
+
+static TrailBuffer MakePresenterTrail()
+{
+    TrailBuffer trail;
+    trail.Push({ 150, 40 }, kPresentNow - 2ms);
+    trail.Push({ 90, 70 }, kPresentNow - 10ms);
+    trail.Push({ 30, 50 }, kPresentNow - 30ms);
+    return trail;
+}
+
+// Stands in for the compositor: keeps each visual's state and blends the visible ones in
+// stacking order when a frame is committed
+class RecordingBackend final : public SpriteVisualBackend
+{
+public:
+    bool SetSprite(const Sprite& sprite) override
+    {
+        ++uploads;
+        sprite_ = sprite;
+        return !failUploads;
+    }
+
+    size_t Reserve(size_t count) override
+    {
+        visuals_.resize(std::max(visuals_.size(), std::min(count, limit)));
+        return visuals_.size();
+    }
+
+    void Place(size_t i, int x, int y, uint8_t alpha, int frame) override
+    {
+        visuals_[i] = { x, y, alpha, frame };
+        ++places;
+    }
+
+    void Hide(size_t i) override
+    {
+        visuals_[i] = {};
+        ++hides;
+    }
+
+    void Commit() override
+    {
+        ++commits;
+        screen.Resize(200, 120);
+        for (const SpriteStamp& v : visuals_)
+        {
+            if (v.alpha)
+                BlendSprite(screen.View(), sprite_, v.x, v.y, v.alpha, v.frame);
+        }
+    }
+
+    [[nodiscard]] size_t Visible() const
+    {
+        size_t n = 0;
+        for (const SpriteStamp& v : visuals_)
+            n += v.alpha != 0;
+        return n;
+    }
+
+    PixelBuffer screen;
+    size_t limit = static_cast<size_t>(-1);
+    bool failUploads = false;
+    int uploads = 0, places = 0, hides = 0, commits = 0;
+
+private:
+    Sprite sprite_;
+    std::vector<SpriteStamp> visuals_;
+};
+
+static PixelBuffer RenderReference(const Sprite& sprite, const TrailBuffer& trail, int originX, int originY)
+{
+    PixelBuffer ref;
+    ref.Resize(200, 120);
+    RenderTrail(ref.View(), sprite, trail, originX, originY, kPresentNow, PresenterSettings());
+    return ref;
+}
+
+TEST(Presenter, CollectedStampsReproduceRenderTrail)
+{
+    const Sprite sprite = MakePresenterSprite();
+    const TrailBuffer trail = MakePresenterTrail();
+    const TrailSettings settings = PresenterSettings();
+    TrailAlphaLut lut;
+    lut.Update(settings);
+
+    std::vector<SpriteStamp> stamps;
+    const size_t n = CollectStamps(sprite, trail, kPresentNow, settings, lut, stamps);
+    CHECK(n > 10);
+    CHECK_EQ(n, stamps.size());
+
+    PixelBuffer blended;
+    blended.Resize(200, 120);
+    for (const SpriteStamp& s : stamps)
+    {
+        CHECK(s.alpha >= 3);
+        BlendSprite(blended.View(), sprite, s.x, s.y, s.alpha, s.frame);
+    }
+
+    PixelBuffer ref;
+    ref.Resize(200, 120);
+    const TrailRenderStats stats = RenderTrail(ref.View(), sprite, trail, 0, 0, kPresentNow, settings, lut);
+    CHECK(blended.px == ref.px);
+    CHECK_EQ(stats.stamps, static_cast<int>(n));
+}
+
+TEST(Presenter, OffscreenMatchesRenderTrailAndClears)
+{
+    const Sprite sprite = MakePresenterSprite();
+    TrailBuffer trail = MakePresenterTrail();
+    OffscreenPresenter presenter({ 10, 5, 210, 125 });
+    CHECK(!presenter.ShowsTrail());
+
+    const TrailRenderStats stats = presenter.Present(sprite, trail, kPresentNow, PresenterSettings());
+    CHECK(stats.stamps > 10);
+    CHECK(presenter.ShowsTrail());
+    CHECK(presenter.Surface().px == RenderReference(sprite, trail, 10, 5).px);
+
+    trail.Clear();
+    presenter.Present(sprite, trail, kPresentNow, PresenterSettings());
+    CHECK(!presenter.ShowsTrail());
+    for (uint32_t p : presenter.Surface().px)
+        CHECK_EQ(p, 0u);
+}
+
+TEST(Presenter, SpriteVisualsComposeLikeRenderTrail)
+{
+    const Sprite sprite = MakePresenterSprite();
+    const TrailBuffer trail = MakePresenterTrail();
+    RecordingBackend backend;
+    SpriteVisualPresenter presenter(backend);
+    presenter.SetOrigin(10, 5);
+
+    const TrailRenderStats stats = presenter.Present(sprite, trail, kPresentNow, PresenterSettings());
+    CHECK(presenter.ShowsTrail());
+    CHECK_EQ(stats.pixelsBlended, 0u); // Blending is left to the compositor
+    CHECK_EQ(backend.Visible(), static_cast<size_t>(stats.stamps));
+    CHECK_EQ(backend.commits, 1);
+    CHECK(backend.screen.px == RenderReference(sprite, trail, 10, 5).px);
+}
+
+TEST(Presenter, SpriteVisualsUploadOnceAndSkipUnchangedFrames)
+{
+    const Sprite sprite = MakePresenterSprite();
+    const TrailBuffer trail = MakePresenterTrail();
+    RecordingBackend backend;
+    SpriteVisualPresenter presenter(backend);
+
+    const TrailRenderStats stats = presenter.Present(sprite, trail, kPresentNow, PresenterSettings());
+    CHECK_EQ(backend.places, stats.stamps);
+
+    // Same trail at the same time: nothing to move or fade
+    presenter.Present(sprite, trail, kPresentNow, PresenterSettings());
+    CHECK_EQ(backend.uploads, 1);
+    CHECK_EQ(backend.commits, 1);
+    CHECK_EQ(backend.places, stats.stamps);
+    CHECK_EQ(presenter.Updates(), static_cast<uint64_t>(stats.stamps));
+
+    // A copy of the same image is not uploaded again; a different one replaces every visual
+    const Sprite copy = sprite;
+    presenter.Present(copy, trail, kPresentNow, PresenterSettings());
+    CHECK_EQ(backend.uploads, 1);
+
+    Sprite tinted = sprite;
+    tinted.px[0] ^= 0x00010101u;
+    presenter.Present(tinted, trail, kPresentNow, PresenterSettings());
+    CHECK_EQ(backend.uploads, 2);
+    CHECK_EQ(backend.places, stats.stamps * 2);
+    CHECK_EQ(backend.commits, 2);
+}
+
+TEST(Presenter, SpriteVisualsHideWhenTrailEmpties)
+{
+    const Sprite sprite = MakePresenterSprite();
+    TrailBuffer trail = MakePresenterTrail();
+    RecordingBackend backend;
+    SpriteVisualPresenter presenter(backend);
+
+    const TrailRenderStats stats = presenter.Present(sprite, trail, kPresentNow, PresenterSettings());
+    trail.Clear();
+    presenter.Present(sprite, trail, kPresentNow, PresenterSettings());
+    CHECK(!presenter.ShowsTrail());
+    CHECK_EQ(backend.hides, stats.stamps);
+    CHECK_EQ(backend.Visible(), 0u);
+    for (uint32_t p : backend.screen.px)
+        CHECK_EQ(p, 0u);
+
+    // Hidden visuals are not hidden again
+    presenter.Present(sprite, trail, kPresentNow, PresenterSettings());
+    CHECK_EQ(backend.hides, stats.stamps);
+    CHECK_EQ(backend.commits, 2);
+}
+
+// Presents through a pool of at most maxVisuals, of which the backend can allocate backendLimit,
+// and checks that exactly the newest pool stamps are composed
+static void CheckNewestStampsKept(size_t maxVisuals, size_t backendLimit, size_t pool)
+{
+    const Sprite sprite = MakePresenterSprite();
+    const TrailBuffer trail = MakePresenterTrail();
+    const TrailSettings settings = PresenterSettings();
+    TrailAlphaLut lut;
+    lut.Update(settings);
+    std::vector<SpriteStamp> stamps;
+    CollectStamps(sprite, trail, kPresentNow, settings, lut, stamps);
+    CHECK(stamps.size() > pool);
+
+    RecordingBackend backend;
+    backend.limit = backendLimit;
+    SpriteVisualPresenter presenter(backend, maxVisuals);
+    const TrailRenderStats stats = presenter.Present(sprite, trail, kPresentNow, settings);
+    CHECK_EQ(static_cast<size_t>(stats.stamps), pool);
+    CHECK_EQ(backend.Visible(), pool);
+
+    PixelBuffer ref;
+    ref.Resize(200, 120);
+    for (size_t i = stamps.size() - pool; i < stamps.size(); ++i)
+        BlendSprite(ref.View(), sprite, stamps[i].x, stamps[i].y, stamps[i].alpha, stamps[i].frame);
+    CHECK(backend.screen.px == ref.px);
+}
+
+TEST(Presenter, SpriteVisualsKeepNewestStampsBeyondPool)
+{
+    CheckNewestStampsKept(8, static_cast<size_t>(-1), 8);
+}
+
+TEST(Presenter, SpriteVisualsKeepNewestStampsBackendShort)
+{
+    CheckNewestStampsKept(kMaxSpriteVisuals, 5, 5);
+}
+
+TEST(Presenter, SpriteVisualsShowNothingWithoutSprite)
+{
+    const Sprite sprite = MakePresenterSprite();
+    const TrailBuffer trail = MakePresenterTrail();
+    RecordingBackend backend;
+    backend.failUploads = true;
+    SpriteVisualPresenter presenter(backend);
+
+    const TrailRenderStats stats = presenter.Present(sprite, trail, kPresentNow, PresenterSettings());
+    CHECK_EQ(stats.stamps, 0);
+    CHECK(!presenter.ShowsTrail());
+    CHECK_EQ(backend.places, 0);
+
+    // Retried on the next frame
+    backend.failUploads = false;
+    presenter.Present(sprite, trail, kPresentNow, PresenterSettings());
+    CHECK_EQ(backend.uploads, 2);
+    CHECK(presenter.ShowsTrail());
+}
@@ -0,0 +1,114 @@
+#include "Tests/Test.h"
+#include "Core/SpriteCache.h"
+#include <algorithm>
+
+static std::vector<uint32_t> Pixels(int w, int h, uint32_t value)
+{
+    return std::vector<uint32_t>(static_cast<size_t>(w) * h, value);
+}
+
+static SpriteKey Key(uintptr_t cursor, int size, uint32_t tint = 0xFFFFFF, int dpi = 96)
+{
+    SpriteKey k;
+    k.cursor = cursor;
+    k.w = k.h = size;
+    k.tint = tint;
+    k.dpi = dpi;
+    return k;
+}
+
+TEST(SpriteCache, HitsAfterInsertAndTints)
+{
+    SpriteCache cache;
+    CHECK(cache.Find(Key(1, 4, 0x80FF40)) == nullptr);
+
+    const std::vector<uint32_t> src = Pixels(4, 4, 0xFFFFFFFFu);
+    const Sprite& s = cache.Insert(Key(1, 4, 0x80FF40), src.data(), 4, 1, 2);
+    CHECK_EQ(s.hotX, 1);
+    CHECK_EQ(s.hotY, 2);
+    CHECK_EQ(s.px[0], 0xFF80FF40u);
+    CHECK_EQ(reinterpret_cast<uintptr_t>(s.px.data()) % kPixelAlign, uintptr_t(0));
+
+    CHECK(cache.Find(Key(1, 4, 0x80FF40)) == &s);
+    CHECK_EQ(cache.Hits(), uint64_t(1));
+    CHECK_EQ(cache.Misses(), uint64_t(1));
+}
+
+TEST(SpriteCache, KeyIncludesSizeTintAndDpi)
+{
+    SpriteCache cache;
+    const std::vector<uint32_t> src = Pixels(8, 8, 0xFF808080u);
+    cache.Insert(Key(7, 4), src.data(), 8, 0, 0);
+    CHECK(cache.Find(Key(7, 8)) == nullptr);
+    CHECK(cache.Find(Key(7, 4, 0xFF0000)) == nullptr);
+    CHECK(cache.Find(Key(7, 4, 0xFFFFFF, 144)) == nullptr);
+    CHECK(cache.Find(Key(8, 4)) == nullptr);
+    CHECK(cache.Find(Key(7, 4)) != nullptr);
+
+    // Reinserting a key replaces the entry instead of duplicating it
+    cache.Insert(Key(7, 4), src.data(), 8, 0, 0);
+    CHECK_EQ(cache.Size(), size_t(1));
+    CHECK_EQ(cache.Bytes(), size_t(4 * 4 * 4));
+}
+
+TEST(SpriteCache, EvictsLeastRecentlyUsedOverBudget)
+{
+    SpriteCache cache(3 * 16 * 16 * 4);
+    const std::vector<uint32_t> src = Pixels(16, 16, 0xFFFFFFFFu);
+    cache.Insert(Key(1, 16), src.data(), 16, 0, 0);
+    cache.Insert(Key(2, 16), src.data(), 16, 0, 0);
+    cache.Insert(Key(3, 16), src.data(), 16, 0, 0);
+    CHECK(cache.Find(Key(1, 16)) != nullptr); // 2 is now the oldest
+
+    cache.Insert(Key(4, 16), src.data(), 16, 0, 0);
+    CHECK_EQ(cache.Evictions(), uint64_t(1));
+    CHECK(cache.Find(Key(2, 16)) == nullptr);
+    CHECK(cache.Find(Key(1, 16)) != nullptr);
+    CHECK(cache.Find(Key(3, 16)) != nullptr);
+    CHECK(cache.Bytes() <= size_t(3 * 16 * 16 * 4));
+
+    // An entry bigger than the whole budget is still kept on its own
+    cache.SetBudget(16);
+    CHECK_EQ(cache.Size(), size_t(1));
+    CHECK(cache.Find(Key(3, 16)) != nullptr);
+}
+
+TEST(SpriteCache, VectorTintMatchesScalarFormula)
+{
+    std::vector<uint32_t> px(257);
+    for (size_t i = 0; i < px.size(); ++i)
+        px[i] = static_cast<uint32_t>(i * 0x9E3779B9u);
+    std::vector<uint32_t> tinted = px;
+    TintPixels(tinted.data(), tinted.size(), 201, 37, 255);
+
+    bool same = true;
+    for (size_t i = 0; i < px.size(); ++i)
+    {
+        const uint32_t c = px[i];
+        const uint32_t expected = (c & 0xFF000000u) | ((((c >> 16) & 0xFF) * 201 / 255) << 16) |
+            ((((c >> 8) & 0xFF) * 37 / 255) << 8) | ((c & 0xFF) * 255 / 255);
+        same = same && tinted[i] == expected;
+    }
+    CHECK(same);
+}
+
+TEST(SpriteCache, InsertKeepsAnimationFrames)
+{
+    SpriteCache cache(1 << 20);
+    std::vector<uint32_t> src = Pixels(4, 8, 0xFFFFFFFFu);
+    std::fill(src.begin() + 16, src.end(), 0x80808080u);
+
+    const Sprite& s = cache.Insert(Key(3, 4, 0x00FF00), src.data(), 4, 0, 0, 2, { 50000, 100000 });
+    CHECK(s.Animated());
+    CHECK_EQ(s.h, 4);
+    CHECK_EQ(s.px.size(), size_t(32));
+    CHECK_EQ(s.FramePixels(0)[0], 0xFF00FF00u);
+    CHECK_EQ(s.FramePixels(1)[0], 0x80008000u);
+    CHECK_EQ(cache.Bytes(), size_t(32 * 4));
+
+    // Mismatched timing falls back to a still sprite
+    const Sprite& still = cache.Insert(Key(4, 4), src.data(), 4, 0, 0, 2, { 50000 });
+    CHECK(!still.Animated());
+    CHECK_EQ(still.px.size(), size_t(16));
+}
+
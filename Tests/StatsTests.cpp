@@ -0,0 +1,155 @@
+#include "Tests/Test.h"
+#include "Core/Stats.h"
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+
+TEST(Stats, BucketsAreMonotonicAndTight)
+{
+    int prev = -1;
+    bool monotonic = true, tight = true;
+    for (uint64_t v = 0; v < 100000; v += 7)
+    {
+        const int b = HistogramCounts::BucketOf(v);
+        monotonic = monotonic && b >= prev;
+        prev = b;
+
+        // Bucket midpoint within 1/16 of the value (exact below 8)
+        const double mid = static_cast<double>(HistogramCounts::BucketMid(b));
+        tight = tight && (v < 8 ? mid == static_cast<double>(v) : std::abs(mid - static_cast<double>(v)) <= static_cast<double>(v) / 16.0 + 1.0);
+    }
+    CHECK(monotonic);
+    CHECK(tight);
+    CHECK_EQ(HistogramCounts::BucketOf(~uint64_t(0)), HistogramCounts::kBuckets - 1);
+}
+
+TEST(Stats, PercentilesOfUniformSamples)
+{
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 1000; ++v)
+        h.Record(v * 1000); // 1..1000 us
+
+    HistogramCounts counts;
+    h.Drain(counts, true);
+    CHECK_EQ(counts.count, uint64_t(1000));
+    CHECK_EQ(counts.maxNs, uint64_t(1000000));
+
+    const double p50 = static_cast<double>(counts.Percentile(0.5));
+    const double p99 = static_cast<double>(counts.Percentile(0.99));
+    CHECK(p50 > 500000 * 0.93 && p50 < 500000 * 1.07);
+    CHECK(p99 > 990000 * 0.93 && p99 <= 1000000);
+
+    // Drained with reset
+    h.Drain(counts, false);
+    CHECK_EQ(counts.count, uint64_t(0));
+    CHECK_EQ(counts.Percentile(0.5), uint64_t(0));
+}
+
+TEST(Stats, DisabledRecordsNothing)
+{
+    SetStatsEnabled(false);
+    TakeStatsSnapshot(true);
+    {
+        ScopedStageTimer t(StatStage::Composite);
+        AddCounter(StatCounter::Stamps, 5);
+    }
+    StatsSnapshot snap = TakeStatsSnapshot(true);
+    CHECK_EQ(snap.stages[static_cast<int>(StatStage::Composite)].count, uint64_t(0));
+    CHECK_EQ(snap.counters[static_cast<int>(StatCounter::Stamps)], uint64_t(0));
+
+    SetStatsEnabled(true);
+    {
+        ScopedStageTimer t(StatStage::Composite);
+        AddCounter(StatCounter::Stamps, 5);
+        AddCounter(StatCounter::Stamps, 2);
+        SetGauge(StatGauge::SamplesAlive, 42);
+    }
+    snap = TakeStatsSnapshot(true);
+    SetStatsEnabled(false);
+    CHECK_EQ(snap.stages[static_cast<int>(StatStage::Composite)].count, uint64_t(1));
+    CHECK_EQ(snap.counters[static_cast<int>(StatCounter::Stamps)], uint64_t(7));
+    CHECK_EQ(snap.gauges[static_cast<int>(StatGauge::SamplesAlive)], int64_t(42));
+}
+
+TEST(Stats, JsonLineHasEveryField)
+{
+    StatsSnapshot snap;
+    snap.intervalMs = 1000;
+    snap.stages[static_cast<int>(StatStage::Present)] = { 3, 1500, 9000, 12000 };
+    snap.counters[static_cast<int>(StatCounter::PixelsBlended)] = 123456;
+    const std::string line = StatsJsonLine(snap, 5000);
+
+    CHECK(line.front() == '{' && line.back() == '}');
+    CHECK(line.find('\n') == std::string::npos);
+    CHECK(line.find("\"t_ms\":5000") != std::string::npos);
+    CHECK(line.find("\"present\":{\"n\":3,\"p50_us\":1.500,\"p99_us\":9.000,\"max_us\":12.000}") != std::string::npos);
+    CHECK(line.find("\"pixels_blended\":123456") != std::string::npos);
+    CHECK(line.find("\"samples_alive\":0") != std::string::npos);
+}
+
+TEST(Stats, FrameIntervalJitterBuckets)
+{
+    CHECK_EQ(JitterBucketOf(-2000000), 0);
+    CHECK_EQ(JitterBucketOf(-1000000), 1);
+    CHECK_EQ(JitterBucketOf(0), 3);
+    CHECK_EQ(JitterBucketOf(49999), 3);
+    CHECK_EQ(JitterBucketOf(50000), 4);
+    CHECK_EQ(JitterBucketOf(10000000), kJitterBuckets - 1);
+
+    SetStatsEnabled(true);
+    TakeStatsSnapshot(true);
+    const auto target = std::chrono::nanoseconds(6944444);
+    RecordFrameInterval(target + std::chrono::microseconds(10), target);
+    RecordFrameInterval(target + std::chrono::microseconds(600), target);
+    RecordFrameInterval(target - std::chrono::microseconds(100), target);
+    const StatsSnapshot snap = TakeStatsSnapshot(true);
+    SetStatsEnabled(false);
+
+    CHECK_EQ(snap.stages[static_cast<int>(StatStage::Interval)].count, uint64_t(3));
+    CHECK_EQ(snap.jitter[2], uint64_t(1));
+    CHECK_EQ(snap.jitter[3], uint64_t(1));
+    CHECK_EQ(snap.jitter[5], uint64_t(1));
+
+    const std::string line = StatsJsonLine(snap, 0);
+    CHECK(line.find("\"jitter_us\":{\"edges\":[-1000,-250,-50,50,250,1000,4000],\"counts\":[0,0,1,1,0,1,0,0]}") != std::string::npos);
+}
+
+TEST(Stats, WriterAppendsJsonLines)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "cursorblur_stats_test.jsonl").string();
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    CHECK(file != nullptr);
+    if (!file)
+        return;
+
+    StatsWriter writer;
+    CHECK(writer.Start(file, std::chrono::milliseconds(5)));
+    CHECK(StatsEnabled());
+    for (int i = 0; i < 20; ++i)
+    {
+        AddCounter(StatCounter::Frames);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    writer.Stop();
+    CHECK(!StatsEnabled());
+    CHECK(writer.LinesWritten() >= 2);
+
+    std::FILE* reader = std::fopen(path.c_str(), "r");
+    CHECK(reader != nullptr);
+    if (!reader)
+        return;
+
+    char buf[4096];
+    uint64_t lines = 0, frames = 0;
+    while (std::fgets(buf, sizeof(buf), reader))
+    {
+        ++lines;
+        const char* f = std::strstr(buf, "\"frames\":");
+        if (f)
+            frames += std::strtoull(f + 9, nullptr, 10);
+    }
+    std::fclose(reader);
+    std::remove(path.c_str());
+    CHECK_EQ(lines, writer.LinesWritten());
+    CHECK_EQ(frames, uint64_t(20));
+}
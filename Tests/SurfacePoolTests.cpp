@@ -0,0 +1,77 @@
+#include "Tests/Test.h"
+#include "Core/SurfacePool.h"
+#include "Core/Surface.h"
+#include "Core/Compositor.h"
+
+static bool AllocBuffer(PixelBuffer& b, int w, int h)
+{
+    b.Resize(w, h);
+    return true;
+}
+
+TEST(SurfacePool, BucketDims)
+{
+    CHECK_EQ(PoolBucketDim(1), 128);
+    CHECK_EQ(PoolBucketDim(128), 128);
+    CHECK_EQ(PoolBucketDim(129), 192);
+    CHECK_EQ(PoolBucketDim(700), 768);
+    CHECK_EQ(PoolBucketDim(1024), 1024);
+    CHECK_EQ(PoolBucketDim(1025), 1536);
+}
+
+TEST(SurfacePool, ReusesFittingSurface)
+{
+    SurfacePool<PixelBuffer> pool;
+    PixelBuffer* a = pool.Acquire(100, 60, AllocBuffer);
+    CHECK(a != nullptr);
+    CHECK_EQ(a->w, 128);
+
+    PixelBuffer* b = pool.Acquire(120, 128, AllocBuffer);
+    CHECK(a == b);
+    CHECK_EQ(pool.Allocations(), uint64_t(1));
+    CHECK_EQ(pool.Bytes(), size_t(128 * 128 * 4));
+}
+
+TEST(SurfacePool, PicksSmallestFitAndEvictsLru)
+{
+    SurfacePool<PixelBuffer, 2> pool;
+    PixelBuffer* small = pool.Acquire(10, 10, AllocBuffer);
+    PixelBuffer* big = pool.Acquire(500, 500, AllocBuffer);
+    CHECK(small != big);
+    CHECK(pool.Acquire(50, 50, AllocBuffer) == small);
+
+    // Pool is full; the least recently used (big) surface is replaced
+    PixelBuffer* wide = pool.Acquire(2000, 10, AllocBuffer);
+    CHECK(wide == big);
+    CHECK_EQ(wide->w, 2048);
+    CHECK(pool.Acquire(50, 50, AllocBuffer) == small);
+    CHECK_EQ(pool.Allocations(), uint64_t(3));
+}
+
+TEST(SurfacePool, FailedAllocationReturnsNull)
+{
+    SurfacePool<PixelBuffer> pool;
+    CHECK(pool.Acquire(10, 10, [](PixelBuffer&, int, int) { return false; }) == nullptr);
+    CHECK_EQ(pool.Bytes(), size_t(0));
+}
+
+TEST(SurfacePool, TrailBoundsCoverSpriteExtent)
+{
+    Sprite s;
+    s.w = 32;
+    s.h = 24;
+    s.hotX = 4;
+    s.hotY = 2;
+    s.px.assign(static_cast<size_t>(s.w) * s.h, 0u);
+
+    TrailBuffer trail;
+    CHECK(TrailBounds(trail, s).Empty());
+
+    trail.Push({ 100, 50 }, {});
+    trail.Push({ 40, 80 }, {});
+    const PixelRect r = TrailBounds(trail, s);
+    CHECK_EQ(r.left, 36);
+    CHECK_EQ(r.top, 48);
+    CHECK_EQ(r.right, 128);
+    CHECK_EQ(r.bottom, 102);
+}
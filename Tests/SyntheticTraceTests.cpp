@@ -0,0 +1,50 @@
+#include "Tests/Test.h"
+#include "Core/SyntheticTrace.h"
+
+TEST(SyntheticTrace, PatternsStayOnScreenAndInOrder)
+{
+    for (int i = 0; i < static_cast<int>(TracePattern::Count); ++i)
+    {
+        const TracePattern pattern = static_cast<TracePattern>(i);
+        const std::vector<TraceSample> trace = MakeSyntheticTrace(pattern, 640, 480, 500);
+        CHECK(!trace.empty());
+
+        bool ordered = true, onScreen = true;
+        for (size_t k = 0; k < trace.size(); ++k)
+        {
+            ordered = ordered && (k == 0 || trace[k].us > trace[k - 1].us);
+            onScreen = onScreen && trace[k].pt.x >= 0 && trace[k].pt.x < 640 && trace[k].pt.y >= 0 && trace[k].pt.y < 480;
+        }
+        CHECK(ordered);
+        CHECK(onScreen);
+
+        if (pattern == TracePattern::Idle)
+            CHECK_EQ(trace.size(), size_t(1));
+        else
+            CHECK_EQ(trace.size(), size_t(501)); // 1000 Hz, both ends included
+    }
+}
+
+TEST(SyntheticTrace, DeterministicPerSeed)
+{
+    const auto a = MakeSyntheticTrace(TracePattern::Flicks, 800, 600, 2000, 1000, 7);
+    const auto b = MakeSyntheticTrace(TracePattern::Flicks, 800, 600, 2000, 1000, 7);
+    const auto c = MakeSyntheticTrace(TracePattern::Flicks, 800, 600, 2000, 1000, 8);
+
+    bool same = a.size() == b.size(), differs = false;
+    for (size_t k = 0; same && k < a.size(); ++k)
+        same = a[k].pt.x == b[k].pt.x && a[k].pt.y == b[k].pt.y;
+    for (size_t k = 0; k < a.size() && k < c.size(); ++k)
+        differs = differs || a[k].pt.x != c[k].pt.x;
+    CHECK(same);
+    CHECK(differs);
+}
+
+TEST(SyntheticTrace, ParsesNames)
+{
+    TracePattern p = TracePattern::Idle;
+    CHECK(ParseTracePattern("Circles", p));
+    CHECK(p == TracePattern::Circles);
+    CHECK(!ParseTracePattern("circle", p));
+    CHECK(!ParseTracePattern("circless", p));
+}
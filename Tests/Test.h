@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal self-registering test harness so the core builds without external deps
+
+struct TestCase final
+{
+    const char* name;
+    std::function<void()> fn;
+};
+
+std::vector<TestCase>& TestRegistry();
+void TestFail(const char* file, int line, const std::string& msg);
+
+struct TestRegistrar final
+{
+    TestRegistrar(const char* name, std::function<void()> fn) { TestRegistry().push_back({ name, std::move(fn) }); }
+};
+
+#define TEST_CONCAT_INNER(a, b) a##b
+#define TEST_CONCAT(a, b) TEST_CONCAT_INNER(a, b)
+
+#define TEST(suite, name) \
+    static void suite##_##name(); \
+    static TestRegistrar TEST_CONCAT(sReg_, __LINE__)(#suite "." #name, suite##_##name); \
+    static void suite##_##name()
+
+#define CHECK(cond) \
+    do { if (!(cond)) TestFail(__FILE__, __LINE__, "CHECK(" #cond ")"); } while (0)
+
+#define CHECK_EQ(a, b) \
+    do { const auto& va_ = (a); const auto& vb_ = (b); if (!(va_ == vb_)) \
+        TestFail(__FILE__, __LINE__, "CHECK_EQ(" #a ", " #b "): " + std::to_string(va_) + " != " + std::to_string(vb_)); } while (0)
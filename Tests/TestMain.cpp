@@ -0,0 +1,43 @@
+#include "Tests/Test.h"
+#include <cstring>
+
+static int sFailures = 0;
+
+std::vector<TestCase>& TestRegistry()
+{
+    static std::vector<TestCase> registry;
+    return registry;
+}
+
+void TestFail(const char* file, int line, const std::string& msg)
+{
+    std::fprintf(stderr, "%s:%d: %s\n", file, line, msg.c_str());
+    ++sFailures;
+}
+
+// Usage: CursorBlurTests [name prefix]
+int main(int argc, char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : "";
+    int ran = 0, failed = 0;
+
+    for (const TestCase& tc : TestRegistry())
+    {
+        if (std::strncmp(tc.name, filter, std::strlen(filter)) != 0)
+            continue;
+
+        const int before = sFailures;
+        tc.fn();
+        ++ran;
+        if (sFailures != before)
+        {
+            ++failed;
+            std::printf("[FAIL] %s\n", tc.name);
+        }
+        else
+            std::printf("[ OK ] %s\n", tc.name);
+    }
+
+    std::printf("%d/%d passed\n", ran - failed, ran);
+    return (failed == 0 && ran > 0) ? 0 : 1;
+}
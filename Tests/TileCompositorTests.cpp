@@ -0,0 +1,171 @@
+#include "Tests/Test.h"
+#include "Core/TileCompositor.h"
+#include "Core/TrailRenderer.h"
+#include <cmath>
+
+using namespace std::chrono_literals;
+
+TEST(WorkStealingPool, RunsEveryIndexOnce)
+{
+    WorkStealingPool pool(4);
+    CHECK_EQ(pool.Threads(), 4);
+
+    std::vector<std::atomic<int>> runs(1000);
+    for (int batch = 0; batch < 20; ++batch)
+        pool.Run(runs.size(), [&](size_t i) { runs[i].fetch_add(1, std::memory_order_relaxed); });
+
+    for (const std::atomic<int>& r : runs)
+        CHECK_EQ(r.load(), 20);
+    pool.Run(0, [&](size_t) { runs[0].store(-1); });
+    CHECK_EQ(runs[0].load(), 20);
+}
+
+TEST(WorkStealingPool, SingleThreadRunsInline)
+{
+    WorkStealingPool pool(0);
+    CHECK_EQ(pool.Threads(), 1);
+
+    const std::thread::id caller = std::this_thread::get_id();
+    bool inline_ = true;
+    size_t next = 0;
+    bool ordered = true;
+    pool.Run(8, [&](size_t i)
+    {
+        inline_ = inline_ && std::this_thread::get_id() == caller;
+        ordered = ordered && i == next++;
+    });
+    CHECK(inline_);
+    CHECK(ordered);
+    CHECK_EQ(next, size_t{ 8 });
+}
+
+TEST(WorkStealingPool, IdleThreadStealsFromBusyOne)
+{
+    // The second half of the batch starts on the worker and is slow; the caller finishes its
+    // own half at once and takes the rest from the front of the worker's queue
+    WorkStealingPool pool(2);
+    std::atomic<int> done{ 0 };
+    pool.Run(32, [&](size_t i)
+    {
+        if (i >= 16)
+            std::this_thread::sleep_for(2ms);
+        done.fetch_add(1, std::memory_order_relaxed);
+    });
+    CHECK_EQ(done.load(), 32);
+    CHECK(pool.Steals() > 0);
+}
+
+static Sprite MakeTileSprite(int size, int frames = 1)
+{
+    Sprite s;
+    s.w = s.h = size;
+    s.hotX = size / 3;
+    s.hotY = size / 4;
+    s.frames = frames;
+    s.px.resize(static_cast<size_t>(size) * size * frames);
+    for (size_t i = 0; i < s.px.size(); ++i)
+    {
+        const uint32_t a = static_cast<uint32_t>(60 + (i * 13) % 196);
+        s.px[i] = (a << 24) | (a << 16) | ((a * 3 / 4) << 8) | (a / 2);
+    }
+    if (frames > 1)
+    {
+        for (int f = 0; f < frames; ++f)
+            s.frameEndUs.push_back(3000 * (f + 1));
+    }
+    return s;
+}
+
+// Fast circle sampled every millisecond, long enough to cover many tiles
+static TrailBuffer MakeCircleTrail(TrailClock::time_point now)
+{
+    TrailBuffer trail;
+    for (int i = 120; i >= 0; --i)
+    {
+        const double a = i * 0.09;
+        trail.Push({ 260 + static_cast<int>(std::lround(200 * std::cos(a))), 170 + static_cast<int>(std::lround(140 * std::sin(a))) },
+            now - std::chrono::milliseconds(i));
+    }
+    return trail;
+}
+
+TEST(TileCompositor, MatchesRenderTrailAtAnyThreadCount)
+{
+    const auto now = TrailClock::time_point{} + 1s;
+    const TrailBuffer trail = MakeCircleTrail(now);
+    TrailSettings settings;
+    settings.maxAlpha = 120;
+    settings.fadeMs = 150.f;
+
+    for (const int frames : { 1, 3 })
+    {
+        const Sprite sprite = MakeTileSprite(48, frames);
+
+        // Not a multiple of the tile size, and offset from the screen origin
+        PixelBuffer ref;
+        ref.Resize(517, 349);
+        const TrailRenderStats want = RenderTrail(ref.View(), sprite, trail, 7, 5, now, settings);
+        CHECK(want.pixelsBlended > kMinParallelPixels);
+
+        for (const int threads : { 1, 2, 3, 4 })
+        {
+            WorkStealingPool pool(threads);
+            TileCompositor tiles;
+            PixelBuffer out;
+            out.Resize(517, 349);
+            const TrailRenderStats got = tiles.Render(out.View(), sprite, trail, 7, 5, now, settings, pool);
+            CHECK(out.px == ref.px);
+            CHECK_EQ(got.stamps, want.stamps);
+            CHECK_EQ(got.pixelsBlended, want.pixelsBlended);
+            CHECK_EQ(got.bounds.left, want.bounds.left);
+            CHECK_EQ(got.bounds.top, want.bounds.top);
+            CHECK_EQ(got.bounds.right, want.bounds.right);
+            CHECK_EQ(got.bounds.bottom, want.bounds.bottom);
+            CHECK_EQ(tiles.ParallelFrames(), uint64_t(threads > 1 ? 1 : 0));
+        }
+    }
+}
+
+TEST(TileCompositor, SmallFramesStayOnOneThread)
+{
+    const auto now = TrailClock::time_point{} + 1s;
+    TrailBuffer trail;
+    trail.Push({ 40, 40 }, now - 4ms);
+    trail.Push({ 46, 42 }, now - 2ms);
+    const Sprite sprite = MakeTileSprite(16);
+    TrailSettings settings;
+    settings.maxAlpha = 200;
+
+    WorkStealingPool pool(4);
+    TileCompositor tiles;
+    PixelBuffer out, ref;
+    out.Resize(128, 128);
+    ref.Resize(128, 128);
+    const TrailRenderStats got = tiles.Render(out.View(), sprite, trail, 0, 0, now, settings, pool);
+    const TrailRenderStats want = RenderTrail(ref.View(), sprite, trail, 0, 0, now, settings);
+    CHECK(got.stamps > 0);
+    CHECK_EQ(got.pixelsBlended, want.pixelsBlended);
+    CHECK(out.px == ref.px);
+    CHECK_EQ(tiles.ParallelFrames(), uint64_t(0));
+}
+
+TEST(TileCompositor, RendererUsesPoolForStamping)
+{
+    const auto now = TrailClock::time_point{} + 1s;
+    const TrailBuffer trail = MakeCircleTrail(now);
+    const Sprite sprite = MakeTileSprite(40);
+    TrailSettings settings;
+    settings.maxAlpha = 90;
+    settings.fadeMs = 150.f;
+
+    WorkStealingPool pool(3);
+    TrailRenderer renderer;
+    renderer.SetPool(&pool);
+    PixelBuffer out, ref;
+    out.Resize(520, 360);
+    ref.Resize(520, 360);
+    renderer.Render(out.View(), sprite, trail, 0, 0, now, settings);
+    RenderTrail(ref.View(), sprite, trail, 0, 0, now, settings);
+    CHECK(out.px == ref.px);
+    CHECK_EQ(renderer.Tiles().ParallelFrames(), uint64_t(1));
+}
@@ -0,0 +1,121 @@
+#include "Tests/Test.h"
+#include "Core/SyntheticTrace.h"
+#include "Core/TraceFile.h"
+#include <filesystem>
+#include <string>
+
+static std::vector<uint8_t> Encode(const std::vector<TraceSample>& trace)
+{
+    std::vector<uint8_t> bytes;
+    TraceEncoder encoder;
+    for (const TraceSample& s : trace)
+        encoder.Append(bytes, s);
+    return bytes;
+}
+
+static bool SameSamples(const std::vector<TraceSample>& a, const std::vector<TraceSample>& b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (a[i].us != b[i].us || a[i].pt.x != b[i].pt.x || a[i].pt.y != b[i].pt.y ||
+            a[i].shape != b[i].shape || a[i].visible != b[i].visible)
+            return false;
+    }
+    return true;
+}
+
+static std::vector<TraceSample> Decode(const std::vector<uint8_t>& bytes)
+{
+    std::vector<TraceSample> out;
+    TraceDecoder decoder(bytes.data(), bytes.size());
+    TraceSample s;
+    while (decoder.Next(s))
+        out.push_back(s);
+    return out;
+}
+
+TEST(TraceFile, SyntheticPatternsRoundTripUnderFourBytesPerSample)
+{
+    for (int i = 0; i < static_cast<int>(TracePattern::Count); ++i)
+    {
+        std::vector<TraceSample> trace = MakeSyntheticTrace(static_cast<TracePattern>(i), 2560, 1440, 5000);
+        // Real mouse reports wobble around the nominal rate
+        for (size_t k = 0; k < trace.size(); ++k)
+            trace[k].us += static_cast<int64_t>((k * 37) % 11);
+
+        const std::vector<uint8_t> bytes = Encode(trace);
+        CHECK(SameSamples(Decode(bytes), trace));
+        if (trace.size() > 1)
+            CHECK(static_cast<double>(bytes.size()) / trace.size() < 4.0);
+    }
+}
+
+TEST(TraceFile, LargeJumpsAndStateChangesRoundTrip)
+{
+    std::vector<TraceSample> trace;
+    trace.push_back({ 0, { -3840, 100 }, 1, true });
+    trace.push_back({ 5, { 7680, -2160 }, 1, true });
+    trace.push_back({ 2000000, { 7681, -2161 }, 4, true });
+    trace.push_back({ 2000001, { 7681, -2161 }, 4, false });
+    trace.push_back({ 1999000, { 0, 0 }, 65535, true }); // Clock stepped back
+    CHECK(SameSamples(Decode(Encode(trace)), trace));
+}
+
+TEST(TraceFile, TruncatedStreamKeepsCompleteSamples)
+{
+    const std::vector<TraceSample> trace = MakeSyntheticTrace(TracePattern::Flicks, 1920, 1080, 1000);
+    std::vector<uint8_t> bytes = Encode(trace);
+    bytes.pop_back();
+
+    const std::vector<TraceSample> decoded = Decode(bytes);
+    CHECK_EQ(decoded.size(), trace.size() - 1);
+    CHECK(SameSamples(decoded, std::vector<TraceSample>(trace.begin(), trace.end() - 1)));
+}
+
+TEST(TraceFile, HeaderRejectsForeignData)
+{
+    std::vector<uint8_t> bytes;
+    TraceHeader header;
+    header.startUnixUs = 1234567890123456;
+    WriteTraceHeader(bytes, header);
+    CHECK_EQ(bytes.size(), kTraceHeaderBytes);
+
+    TraceHeader parsed;
+    CHECK(ParseTraceHeader(bytes.data(), bytes.size(), parsed));
+    CHECK_EQ(parsed.startUnixUs, header.startUnixUs);
+
+    bytes[0] = 'X';
+    CHECK(!ParseTraceHeader(bytes.data(), bytes.size(), parsed));
+    CHECK(!ParseTraceHeader(bytes.data(), 8, parsed));
+}
+
+TEST(TraceFile, RecorderWritesReadableFile)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "cursorblur_trace_test.cbt").string();
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    CHECK(file != nullptr);
+    if (!file)
+        return;
+
+    const auto start = TrailClock::now();
+    TraceRecorder recorder;
+    CHECK(recorder.Start(file, start));
+    for (int i = 0; i < 3000; ++i)
+        recorder.Record({ 100 + i % 50, 200 - i % 7 }, start + std::chrono::microseconds(1000 * i), static_cast<uint16_t>(i / 1000), i % 500 != 0);
+    recorder.Stop();
+    CHECK_EQ(recorder.Recorded() + recorder.Dropped(), uint64_t(3000));
+
+    std::vector<TraceSample> trace;
+    CHECK(LoadTraceFile(path.c_str(), trace));
+    CHECK_EQ(trace.size(), recorder.Recorded());
+    CHECK(!trace.empty());
+    if (trace.empty())
+        return;
+    CHECK_EQ(trace.front().us, int64_t(0));
+    CHECK(!trace.front().visible);
+    CHECK_EQ(trace.back().shape, 2);
+    CHECK_EQ(recorder.BytesWritten(), static_cast<uint64_t>(std::filesystem::file_size(path)));
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,133 @@
+#include "Tests/Test.h"
+#include "Core/TrailAccumulator.h"
+
+using namespace std::chrono_literals;
+
+static Sprite MakeSolidSprite(int w, int h)
+{
+    Sprite s;
+    s.w = w;
+    s.h = h;
+    s.hotX = w / 2;
+    s.hotY = h / 2;
+    s.px.assign(static_cast<size_t>(w) * h, 0xFFFFFFFFu);
+    return s;
+}
+
+static TrailSettings AccumulateSettings()
+{
+    TrailSettings settings;
+    settings.maxAlpha = 200;
+    settings.sensitivity = 1.f;
+    settings.accumulate = true;
+    return settings;
+}
+
+TEST(TrailAccumulator, FirstFrameMatchesRedraw)
+{
+    const Sprite sprite = MakeSolidSprite(8, 8);
+    const TrailSettings settings = AccumulateSettings();
+    const auto now = TrailClock::time_point{} + 1s;
+
+    TrailBuffer trail;
+    trail.Push({ 20, 20 }, now - 10ms);
+    trail.Push({ 60, 30 }, now - 6ms);
+    trail.Push({ 90, 70 }, now - 2ms);
+
+    PixelBuffer a, b;
+    a.Resize(160, 120);
+    b.Resize(160, 120);
+    TrailAccumulator acc;
+    const TrailRenderStats sa = acc.Render(a.View(), sprite, trail, 0, 0, now, settings);
+    const TrailRenderStats sb = RenderTrail(b.View(), sprite, trail, 0, 0, now, settings);
+    CHECK(a.px == b.px);
+    CHECK_EQ(sa.stamps, sb.stamps);
+}
+
+TEST(TrailAccumulator, StampsOnlyNewSegments)
+{
+    const Sprite sprite = MakeSolidSprite(8, 8);
+    const TrailSettings settings = AccumulateSettings();
+    auto now = TrailClock::time_point{} + 1s;
+
+    PixelBuffer buf;
+    buf.Resize(200, 100);
+    TrailBuffer trail;
+    TrailAccumulator acc;
+    trail.Push({ 10, 50 }, now);
+    trail.Push({ 40, 50 }, now + 1ms);
+    now += 2ms;
+    const TrailRenderStats first = acc.Render(buf.View(), sprite, trail, 0, 0, now, settings);
+    CHECK_EQ(first.stamps, 31);
+
+    // Nothing new: only fading happens
+    now += 2ms;
+    const TrailRenderStats idle = acc.Render(buf.View(), sprite, trail, 0, 0, now, settings);
+    CHECK_EQ(idle.stamps, 0);
+    CHECK(idle.pixelsDecayed > 0);
+
+    // One new segment of 10 pixels: 11 stamps including the shared endpoint
+    trail.Push({ 50, 50 }, now);
+    now += 2ms;
+    const TrailRenderStats next = acc.Render(buf.View(), sprite, trail, 0, 0, now, settings);
+    CHECK_EQ(next.stamps, 11);
+}
+
+TEST(TrailAccumulator, FadesOutAndGoesIdle)
+{
+    const Sprite sprite = MakeSolidSprite(8, 8);
+    TrailSettings settings = AccumulateSettings();
+    settings.maxAlpha = 255;
+    auto now = TrailClock::time_point{} + 1s;
+
+    PixelBuffer buf;
+    buf.Resize(300, 200);
+    TrailBuffer trail;
+    TrailAccumulator acc;
+    trail.Push({ 10, 10 }, now);
+    trail.Push({ 250, 150 }, now + 1ms);
+    now += 2ms;
+    acc.Render(buf.View(), sprite, trail, 0, 0, now, settings);
+    CHECK(!acc.LiveBounds().Empty());
+
+    // Premultiplied channels never exceed alpha while fading
+    bool premultiplied = true;
+    for (int frame = 0; frame < 200; ++frame)
+    {
+        now += 4ms;
+        acc.Render(buf.View(), sprite, trail, 0, 0, now, settings);
+        for (uint32_t p : buf.px)
+        {
+            const uint32_t a = p >> 24;
+            premultiplied = premultiplied && ((p >> 16) & 0xFF) <= a && ((p >> 8) & 0xFF) <= a && (p & 0xFF) <= a;
+        }
+    }
+    CHECK(premultiplied);
+
+    // 800 ms is 32 time constants at the default 50 ms fade
+    CHECK(acc.LiveBounds().Empty());
+    bool clear = true;
+    for (uint32_t p : buf.px)
+        clear = clear && p == 0;
+    CHECK(clear);
+
+    const TrailRenderStats idle = acc.Render(buf.View(), sprite, trail, 0, 0, now + 4ms, settings);
+    CHECK_EQ(idle.pixelsDecayed, uint64_t(0));
+    CHECK(idle.bounds.Empty());
+}
+
+TEST(TrailAccumulator, DecayIsUnbiased)
+{
+    PixelBuffer buf;
+    buf.Resize(64, 64);
+    for (uint32_t& p : buf.px)
+        p = 0xC9C9C9C9u; // Alpha 201
+
+    // 201 * 0.5 = 100.5: truncation would give 100 everywhere, dithered rounding keeps the mean
+    DecayRect(buf.View(), { 0, 0, 64, 64 }, 32768, 12345);
+    double sum = 0;
+    for (uint32_t p : buf.px)
+        sum += static_cast<double>(p >> 24);
+    const double mean = sum / static_cast<double>(buf.px.size());
+    CHECK(mean > 100.3 && mean < 100.7);
+}
@@ -0,0 +1,72 @@
+#include "Tests/Test.h"
+#include "Core/TrailBuffer.h"
+
+using namespace std::chrono_literals;
+
+TEST(TrailBuffer, CapacityIsPowerOfTwo)
+{
+    CHECK_EQ(TrailBuffer(500).Capacity(), size_t(512));
+    CHECK_EQ(TrailBuffer(512).Capacity(), size_t(512));
+    CHECK_EQ(TrailBuffer(5000).Capacity(), size_t(8192));
+    CHECK_EQ(TrailBuffer(500).MaxSize(), size_t(500));
+}
+
+TEST(TrailBuffer, WrapsAndSplitsIntoRuns)
+{
+    TrailBuffer buf(8);
+    const auto t0 = TrailClock::time_point{};
+    for (int i = 0; i < 13; ++i)
+        buf.Push({ i, -i }, t0 + std::chrono::milliseconds(i));
+
+    CHECK_EQ(buf.Size(), size_t(8));
+    CHECK_EQ(buf.Point(0).x, 5);
+    CHECK_EQ(buf.Back().x, 12);
+    CHECK_EQ(buf.Back().y, -12);
+    CHECK_EQ(buf.TimeUs(7) - buf.TimeUs(0), 7000);
+
+    TrailBuffer::Run runs[2];
+    CHECK_EQ(buf.Runs(runs), size_t(2));
+    CHECK_EQ(runs[0].count + runs[1].count, size_t(8));
+    CHECK_EQ(runs[0].x[0], 5);
+    CHECK_EQ(runs[1].x[runs[1].count - 1], 12);
+}
+
+TEST(TrailBuffer, ExpireMatchesTruncatedMilliseconds)
+{
+    TrailBuffer buf(16);
+    const auto t0 = TrailClock::time_point{} + 1s;
+    buf.Push({ 0, 0 }, t0);
+    buf.Push({ 1, 0 }, t0 + 500us);
+    buf.Push({ 2, 0 }, t0 + 2ms);
+
+    // Ages 100.9 / 100.4 / 98.9 ms truncate to 100 / 100 / 98: none exceed 100
+    buf.ExpireOlderThan(t0 + 100900us, 100.f);
+    CHECK_EQ(buf.Size(), size_t(3));
+
+    // 101.0 / 100.5 ms -> 101 / 100: only the first goes
+    buf.ExpireOlderThan(t0 + 101ms, 100.f);
+    CHECK_EQ(buf.Size(), size_t(2));
+    CHECK_EQ(buf.Point(0).x, 1);
+
+    buf.ExpireOlderThan(t0 + 1s, 100.f);
+    CHECK(buf.Empty());
+}
+
+TEST(TrailBuffer, RebasesEpochOverLongRuns)
+{
+    TrailBuffer buf(16);
+    auto t = TrailClock::time_point{};
+    buf.Push({ 0, 0 }, t);
+
+    // An hour later the relative timestamps still fit and keep their spacing
+    t += 1h;
+    buf.ExpireOlderThan(t, 100.f);
+    CHECK(buf.Empty());
+    buf.Push({ 1, 0 }, t);
+    buf.Push({ 2, 0 }, t + 3ms);
+    CHECK_EQ(buf.TimeUs(1) - buf.TimeUs(0), 3000);
+    CHECK_EQ(buf.ToUs(t + 3ms), buf.TimeUs(1));
+
+    buf.ExpireOlderThan(t + 103ms, 100.f);
+    CHECK_EQ(buf.Size(), size_t(1));
+}
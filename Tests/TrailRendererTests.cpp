@@ -0,0 +1,286 @@
+#include "Tests/Test.h"
+#include "Core/TrailRenderer.h"
+#include <cstdlib>
+
+using namespace std::chrono_literals;
+
+static Sprite MakeGradientSprite(int w, int h)
+{
+    Sprite s;
+    s.w = w;
+    s.h = h;
+    s.hotX = w / 2;
+    s.hotY = h / 2;
+    s.px.resize(static_cast<size_t>(w) * h);
+    for (int y = 0; y < h; ++y)
+    {
+        for (int x = 0; x < w; ++x)
+        {
+            const uint32_t a = static_cast<uint32_t>(128 + (x * 127) / w);
+            s.px[static_cast<size_t>(y) * w + x] = (a << 24) | (a << 16) | ((a / 2) << 8) | (a / 4);
+        }
+    }
+    return s;
+}
+
+// Mean absolute channel difference over pixels touched in either buffer
+static double MeanChannelError(const PixelBuffer& a, const PixelBuffer& b)
+{
+    double err = 0;
+    size_t touched = 0;
+    for (size_t i = 0; i < a.px.size(); ++i)
+    {
+        if (!a.px[i] && !b.px[i])
+            continue;
+        ++touched;
+        for (int c = 0; c < 32; c += 8)
+            err += std::abs(static_cast<int>((a.px[i] >> c) & 0xFF) - static_cast<int>((b.px[i] >> c) & 0xFF));
+    }
+    return touched ? err / static_cast<double>(touched * 4) : 0.0;
+}
+
+// Renders one segment with both methods and returns the mean absolute channel difference over touched pixels
+static double CompareMethods(TrailPoint from, TrailPoint to, TrailRenderStats& stamp, TrailRenderStats& swept,
+    const Sprite& sprite = MakeGradientSprite(16, 12))
+{
+    TrailSettings settings;
+    settings.maxAlpha = 20;
+    settings.sensitivity = 1.f;
+
+    const auto now = TrailClock::time_point{} + 1s;
+    TrailBuffer trail;
+    trail.Push(to, now - 5ms);
+    trail.Push(from, now - 4ms);
+
+    PixelBuffer a, b;
+    a.Resize(200, 200);
+    b.Resize(200, 200);
+    TrailRenderer renderer;
+    stamp = renderer.Render(a.View(), sprite, trail, 0, 0, now, settings);
+    settings.method = RenderMethod::Swept;
+    swept = renderer.Render(b.View(), sprite, trail, 0, 0, now, settings);
+    return MeanChannelError(a, b);
+}
+
+TEST(TrailRenderer, SweptMatchesStampingHorizontal)
+{
+    TrailRenderStats stamp, swept;
+    const double err = CompareMethods({ 20, 100 }, { 170, 100 }, stamp, swept);
+    CHECK(err < 4.0); // Within ~1.5% per channel on average
+    CHECK_EQ(swept.stamps, stamp.stamps);
+    CHECK_EQ(swept.bounds.left, stamp.bounds.left);
+    CHECK_EQ(swept.bounds.right, stamp.bounds.right);
+    CHECK_EQ(swept.bounds.bottom, stamp.bounds.bottom);
+}
+
+TEST(TrailRenderer, SweptMatchesStampingVertical)
+{
+    TrailRenderStats stamp, swept;
+    const double err = CompareMethods({ 100, 180 }, { 100, 30 }, stamp, swept);
+    CHECK(err < 4.0); // Within ~1.5% per channel on average
+    CHECK_EQ(swept.bounds.top, stamp.bounds.top);
+    CHECK_EQ(swept.bounds.bottom, stamp.bounds.bottom);
+}
+
+TEST(TrailRenderer, SweptMatchesStampingShallowSlope)
+{
+    TrailRenderStats stamp, swept;
+    const double err = CompareMethods({ 20, 40 }, { 170, 46 }, stamp, swept);
+    CHECK(err < 4.0); // Within ~1.5% per channel on average
+    CHECK(swept.pixelsBlended < stamp.pixelsBlended);
+}
+
+TEST(TrailRenderer, SweptMatchesStampingDiagonal)
+{
+    // Integrated along the motion vector whatever the slope, once the cursor is large enough to pay for it
+    const Sprite sprite = MakeGradientSprite(32, 24);
+    TrailRenderStats stamp, swept;
+    double err = CompareMethods({ 20, 30 }, { 170, 120 }, stamp, swept, sprite);
+    CHECK(err < 4.0);
+    CHECK_EQ(swept.stamps, stamp.stamps);
+    CHECK(swept.pixelsBlended < stamp.pixelsBlended);
+
+    err = CompareMethods({ 150, 20 }, { 60, 180 }, stamp, swept, sprite);
+    CHECK(err < 4.0);
+    CHECK(swept.pixelsBlended < stamp.pixelsBlended);
+}
+
+TEST(TrailRenderer, SweptStampsShortSegments)
+{
+    // A segment much shorter than the cursor is cheaper to stamp, so every stamp is blended directly
+    TrailRenderStats stamp, swept;
+    const double err = CompareMethods({ 20, 30 }, { 24, 33 }, stamp, swept);
+    CHECK(err == 0.0);
+    CHECK_EQ(swept.pixelsBlended, stamp.pixelsBlended);
+}
+
+TEST(TrailRenderer, StampMethodMatchesRenderTrail)
+{
+    const Sprite sprite = MakeGradientSprite(8, 8);
+    TrailSettings settings;
+    settings.maxAlpha = 200;
+    settings.sensitivity = 0.5f;
+
+    const auto now = TrailClock::time_point{} + 1s;
+    TrailBuffer trail;
+    trail.Push({ 10, 10 }, now - 8ms);
+    trail.Push({ 40, 25 }, now - 4ms);
+
+    PixelBuffer a, b;
+    a.Resize(64, 64);
+    b.Resize(64, 64);
+    TrailRenderer renderer;
+    renderer.Render(a.View(), sprite, trail, 0, 0, now, settings);
+    RenderTrail(b.View(), sprite, trail, 0, 0, now, settings);
+    CHECK(a.px == b.px);
+}
+
+TEST(TrailRenderer, SamplesAfterNowRenderFresh)
+{
+    // With now before both samples every age clamps to zero, as at the older sample's time
+    const Sprite sprite = MakeGradientSprite(8, 8);
+    TrailSettings settings;
+    settings.maxAlpha = 200;
+    settings.sensitivity = 0.5f;
+
+    const auto t0 = TrailClock::time_point{} + 1s;
+    TrailBuffer trail;
+    trail.Push({ 10, 10 }, t0);
+    trail.Push({ 40, 25 }, t0 + 4ms);
+
+    PixelBuffer a, b;
+    a.Resize(64, 64);
+    b.Resize(64, 64);
+    TrailRenderer renderer;
+    const TrailRenderStats early = renderer.Render(a.View(), sprite, trail, 0, 0, t0 - 3ms, settings);
+    renderer.Render(b.View(), sprite, trail, 0, 0, t0, settings);
+    CHECK(early.stamps > 0);
+    CHECK(a.px == b.px);
+}
+
+TEST(TrailRenderer, SweptStampsAnimatedSprites)
+{
+    Sprite sprite = MakeGradientSprite(8, 16);
+    sprite.h = 8;
+    sprite.frames = 2;
+    sprite.frameEndUs = { 3000, 6000 };
+    TrailSettings settings;
+    settings.maxAlpha = 200;
+    settings.sensitivity = 0.5f;
+    settings.method = RenderMethod::Swept;
+
+    const auto now = TrailClock::time_point{} + 1s;
+    TrailBuffer trail;
+    trail.Push({ 10, 10 }, now - 8ms);
+    trail.Push({ 40, 25 }, now - 2ms);
+
+    PixelBuffer a, b;
+    a.Resize(64, 64);
+    b.Resize(64, 64);
+    TrailRenderer renderer;
+    renderer.Render(a.View(), sprite, trail, 0, 0, now, settings);
+    RenderTrail(b.View(), sprite, trail, 0, 0, now, settings);
+    CHECK(a.px == b.px);
+}
+
+TEST(TrailRenderer, PhaseSpritesShiftByFractions)
+{
+    Sprite dot;
+    dot.w = dot.h = 1;
+    dot.px = { 0xFFFFFFFFu };
+    std::vector<Sprite> phases;
+    BuildPhaseSprites(dot, phases);
+    CHECK_EQ(phases.size(), size_t{ kSubpixelGrid * kSubpixelGrid });
+
+    // Unshifted is the source with a clear extra row and column
+    CHECK_EQ(phases[0].w, 2);
+    CHECK(phases[0].px[0] == 0xFFFFFFFFu && !phases[0].px[1] && !phases[0].px[2] && !phases[0].px[3]);
+
+    // Half a pixel right splits the dot between two columns; a quarter down and right spreads it over four
+    const Sprite& half = phases[kSubpixelGrid / 2];
+    CHECK_EQ(half.px[0] >> 24, 128u);
+    CHECK_EQ(half.px[1] >> 24, 128u);
+    const Sprite& quarter = phases[kSubpixelGrid + 1];
+    CHECK_EQ(quarter.px[0] >> 24, 143u); // 255 * 9/16
+    CHECK_EQ(quarter.px[1] >> 24, 48u);  // 255 * 3/16
+    CHECK_EQ(quarter.px[2] >> 24, 48u);
+    CHECK_EQ(quarter.px[3] >> 24, 16u);  // 255 * 1/16
+
+    // Premultiplied channels never exceed alpha
+    BuildPhaseSprites(MakeGradientSprite(9, 7), phases);
+    bool premultiplied = true;
+    for (const Sprite& p : phases)
+    {
+        for (const uint32_t px : p.px)
+        {
+            for (int c = 0; c < 24; c += 8)
+                premultiplied = premultiplied && ((px >> c) & 0xFF) <= (px >> 24);
+        }
+    }
+    CHECK(premultiplied);
+}
+
+// Slow diagonal drift: a few pixels per sample at a slope rounding turns into stair steps
+static TrailBuffer MakeDriftTrail(TrailClock::time_point now)
+{
+    TrailBuffer trail;
+    for (int i = 30; i >= 0; --i)
+        trail.Push({ 40 + (30 - i) * 5, 40 + (30 - i) * 2 }, now - std::chrono::milliseconds(i));
+    return trail;
+}
+
+TEST(TrailRenderer, SubpixelBeatsRoundedStampsWithFewerStamps)
+{
+    const auto now = TrailClock::time_point{} + 1s;
+    const TrailBuffer trail = MakeDriftTrail(now);
+    const Sprite sprite = MakeGradientSprite(16, 12);
+    TrailSettings settings;
+    settings.maxAlpha = 60;
+    settings.sensitivity = 1.f;
+
+    // Dense sub-pixel stamps stand in for the continuous path
+    TrailRenderer renderer;
+    PixelBuffer ref, rounded, spaced;
+    ref.Resize(240, 140);
+    rounded.Resize(240, 140);
+    spaced.Resize(240, 140);
+    const TrailRenderStats stamp = renderer.Render(rounded.View(), sprite, trail, 0, 0, now, settings);
+    settings.method = RenderMethod::Subpixel;
+    settings.stampSpacing = 0.5f;
+    const TrailRenderStats dense = renderer.Render(ref.View(), sprite, trail, 0, 0, now, settings);
+    settings.stampSpacing = 2.f;
+    const TrailRenderStats sparse = renderer.Render(spaced.View(), sprite, trail, 0, 0, now, settings);
+
+    CHECK(sparse.stamps * 2 < stamp.stamps);
+    CHECK(sparse.stamps * 4 <= dense.stamps + 4);
+    CHECK(MeanChannelError(ref, spaced) * 2 < MeanChannelError(ref, rounded));
+    CHECK_EQ(sparse.bounds.right, dense.bounds.right);
+    CHECK_EQ(sparse.bounds.bottom, dense.bounds.bottom);
+}
+
+TEST(TrailRenderer, SubpixelStampsLandOnNewestSample)
+{
+    const auto now = TrailClock::time_point{} + 1s;
+    TrailBuffer trail;
+    trail.Push({ 10, 10 }, now - 3ms);
+    trail.Push({ 17, 10 }, now - 2ms);
+    trail.Push({ 21, 13 }, now - 1ms);
+
+    Sprite dot;
+    dot.w = dot.h = 1;
+    dot.px = { 0xFFFFFFFFu };
+    TrailSettings settings;
+    settings.maxAlpha = 255;
+    settings.sensitivity = 1.f;
+    settings.method = RenderMethod::Subpixel;
+    settings.stampSpacing = 3.f;
+
+    // 7 + 5 px of path: stamps at 0, 3, ... 12 back from the cursor
+    TrailRenderer renderer;
+    PixelBuffer out;
+    out.Resize(32, 32);
+    const TrailRenderStats stats = renderer.Render(out.View(), dot, trail, 0, 0, now, settings);
+    CHECK_EQ(stats.stamps, 5);
+    CHECK_EQ(out.View().Row(13)[21] >> 24, 255u);
+    CHECK_EQ(out.View().Row(10)[10] >> 24, 255u);
+}
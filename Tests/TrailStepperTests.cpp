@@ -0,0 +1,186 @@
+#include "Tests/Test.h"
+#include "Core/TrailStepper.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+TEST(TrailStepper, PositionsMatchRoundedInterpolation)
+{
+    TrailSettings settings;
+    TrailAlphaLut lut;
+    lut.Update(settings);
+
+    // Every direction and length up to 40px, on both sides of the origin so ties round away from zero
+    bool match = true;
+    int checked = 0;
+    for (int base : { -17, 0, 300 })
+    {
+        for (int dy = -40; dy <= 40; dy += 3)
+        {
+            for (int dx = -40; dx <= 40; dx += 1)
+            {
+                const TrailPoint p0{ base, base / 2 };
+                const TrailPoint p1{ base + dx, base / 2 + dy };
+                const int steps = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(dx * dx + dy * dy))));
+                int j = steps;
+                StepSegment(p0, p1, 0, lut, [&](int x, int y, uint8_t)
+                {
+                    // Exact rational interpolant, rounded half away from zero
+                    const double ex = std::round(p0.x + static_cast<double>(dx) * j / steps);
+                    const double ey = std::round(p0.y + static_cast<double>(dy) * j / steps);
+                    match = match && x == static_cast<int>(ex) && y == static_cast<int>(ey);
+                    --j;
+                    ++checked;
+                });
+                match = match && (dx * dx + dy * dy == 0 || j == -1);
+            }
+        }
+    }
+    CHECK(match);
+    CHECK(checked > 100000);
+}
+
+TEST(TrailStepper, AlphaTracksFadeFormula)
+{
+    TrailSettings settings;
+    settings.maxAlpha = 255;
+    settings.fadeMs = 80.f;
+    TrailAlphaLut lut;
+    lut.Update(settings);
+
+    int maxErr = 0;
+    for (int age = 0; age <= 80; age += 7)
+    {
+        for (int len : { 1, 5, 12, 31, 40, 200 })
+        {
+            const TrailPoint p0{ 10, 10 }, p1{ 10 + len, 10 };
+            const float dist = static_cast<float>(len);
+            int j = len;
+            StepSegment(p0, p1, age, lut, [&](int, int, uint8_t a)
+            {
+                const float t = static_cast<float>(j--) / len;
+                const float fade = std::max(0.f, 1.f - (age + age * t * 0.1f) / settings.fadeMs);
+                const float speed = std::clamp(dist * settings.sensitivity, 0.f, 1.f);
+                const int expected = static_cast<int>(std::clamp(settings.maxAlpha * fade * speed, 0.f, 255.f));
+                maxErr = std::max(maxErr, std::abs(expected - a));
+            });
+        }
+    }
+    CHECK(maxErr <= 2);
+}
+
+TEST(TrailStepper, AgesBeforeNowReadAsFresh)
+{
+    // A sample stamped after now, e.g. from a skewed input timestamp, has a negative age
+    TrailSettings settings;
+    settings.maxAlpha = 200;
+    TrailAlphaLut lut;
+    lut.Update(settings);
+
+    const TrailPoint p0{ 0, 0 }, p1{ 25, 10 };
+    std::vector<uint8_t> fresh;
+    StepSegment(p0, p1, 0, lut, [&](int, int, uint8_t a) { fresh.push_back(a); });
+    CHECK(fresh.front() > 0);
+
+    for (int age : { -1, -9, -100000 })
+    {
+        std::vector<uint8_t> alphas;
+        StepSegment(p0, p1, age, lut, [&](int, int, uint8_t a) { alphas.push_back(a); });
+        CHECK(alphas == fresh);
+    }
+
+    fresh.clear();
+    StepSegmentIn(p0, p1, 0, lut, 9, [&](int, int, uint8_t a) { fresh.push_back(a); });
+    for (int age : { -1, -100000 })
+    {
+        std::vector<uint8_t> alphas;
+        StepSegmentIn(p0, p1, age, lut, 9, [&](int, int, uint8_t a) { alphas.push_back(a); });
+        CHECK(alphas == fresh);
+        CHECK_EQ(AdaptiveSegmentSteps(p0, p1, age, lut, 8, 250), AdaptiveSegmentSteps(p0, p1, 0, lut, 8, 250));
+    }
+
+    fresh.clear();
+    StepSegmentSubpixel(p0, p1, 0, lut, 2.5f, 0.f, [&](int, int, uint8_t a, float) { fresh.push_back(a); });
+    for (int age : { -1, -100000 })
+    {
+        std::vector<uint8_t> alphas;
+        StepSegmentSubpixel(p0, p1, age, lut, 2.5f, 0.f, [&](int, int, uint8_t a, float) { alphas.push_back(a); });
+        CHECK(alphas == fresh);
+    }
+}
+
+TEST(TrailStepper, LutRebuildsOnlyWhenInputsChange)
+{
+    TrailSettings settings;
+    TrailAlphaLut lut;
+    lut.Update(settings);
+    lut.Update(settings);
+    settings.tintR = 12; // Not an input
+    settings.method = RenderMethod::Swept;
+    lut.Update(settings);
+    CHECK_EQ(lut.Builds(), uint64_t(1));
+
+    settings.fadeMs = 120.f;
+    lut.Update(settings);
+    settings.sensitivity = 0.5f;
+    lut.Update(settings);
+    settings.maxAlpha = 99;
+    lut.Update(settings);
+    CHECK_EQ(lut.Builds(), uint64_t(4));
+}
+
+TEST(TrailStepper, AdaptiveStepsWidenOnlyFaintSegments)
+{
+    TrailSettings settings;
+    settings.maxAlpha = 40;
+    settings.sensitivity = 1.f;
+    settings.fadeMs = 100.f;
+    TrailAlphaLut lut;
+    lut.Update(settings);
+
+    const TrailPoint p0{ 0, 0 }, p1{ 60, 0 };
+    CHECK_EQ(AdaptiveSegmentSteps(p0, p1, 0, lut, 8, 0), 60);  // No budget
+    CHECK_EQ(AdaptiveSegmentSteps(p0, p1, 0, lut, 8, 30), 60); // Brighter than the budget
+    CHECK_EQ(AdaptiveSegmentSteps(p0, p1, 0, lut, 1, 255), 60); // Cursor too small to widen
+
+    // Alpha 20 at half the fade; 1 - (1 - 20/255)^k <= 60/255 up to k = 3.3
+    CHECK_EQ(AdaptiveSegmentSteps(p0, p1, 50, lut, 8, 60), 19);
+    CHECK_EQ(AdaptiveSegmentSteps(p0, p1, 50, lut, 2, 60), 30);
+    CHECK_EQ(AdaptiveSegmentSteps(p0, p1, 50, lut, 8, 255), 8);
+}
+
+TEST(TrailStepper, WidenedStepsKeepEndpointsAndCoverage)
+{
+    TrailSettings settings;
+    settings.maxAlpha = 30;
+    settings.sensitivity = 1.f;
+    settings.fadeMs = 100.f;
+    TrailAlphaLut lut;
+    lut.Update(settings);
+
+    // Full step count is StepSegment exactly
+    const TrailPoint p0{ 5, -3 }, p1{ -32, 14 };
+    std::vector<int> plain, same;
+    StepSegment(p0, p1, 20, lut, [&](int x, int y, uint8_t a) { plain.insert(plain.end(), { x, y, a }); });
+    StepSegmentIn(p0, p1, 20, lut, SegmentSteps(p0, p1), [&](int x, int y, uint8_t a) { same.insert(same.end(), { x, y, a }); });
+    CHECK(plain == same);
+
+    // A quarter of the steps: ends on both samples, positions round the exact interpolant, and
+    // each stamp covers about what the four it replaces did
+    const int steps = SegmentSteps(p0, p1) / 4;
+    int j = steps;
+    bool onPath = true;
+    double keepPlain = 1, keepWide = 1;
+    for (size_t i = 0; i < plain.size(); i += 3)
+        keepPlain *= 1 - plain[i + 2] / 255.0;
+    StepSegmentIn(p0, p1, 20, lut, steps, [&](int x, int y, uint8_t a)
+    {
+        onPath = onPath && x == static_cast<int>(std::round(p0.x + (p1.x - p0.x) * static_cast<double>(j) / steps));
+        onPath = onPath && y == static_cast<int>(std::round(p0.y + (p1.y - p0.y) * static_cast<double>(j) / steps));
+        keepWide *= 1 - a / 255.0;
+        --j;
+    });
+    CHECK(onPath);
+    CHECK_EQ(j, -1);
+    CHECK(std::abs(keepWide - keepPlain) < 0.03);
+}
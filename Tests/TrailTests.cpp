@@ -0,0 +1,51 @@
+#include "Tests/Test.h"
+#include "Core/Trail.h"
+
+using namespace std::chrono_literals;
+
+TEST(Trail, AddsOnlyWhenMoved)
+{
+    TrailBuffer trail(kMaxTrailSize);
+    const TrailSettings settings;
+    const auto t0 = TrailClock::time_point{};
+
+    UpdateTrail(trail, { 10, 10 }, t0, settings);
+    UpdateTrail(trail, { 10, 10 }, t0 + 1ms, settings);
+    CHECK_EQ(trail.Size(), size_t(1));
+
+    UpdateTrail(trail, { 11, 10 }, t0 + 2ms, settings);
+    CHECK_EQ(trail.Size(), size_t(2));
+    CHECK_EQ(trail.Back().x, 11);
+}
+
+TEST(Trail, ExpiresAfterFadeWindow)
+{
+    TrailBuffer trail(kMaxTrailSize);
+    TrailSettings settings;
+    settings.fadeMs = 50.f;
+    const auto t0 = TrailClock::time_point{};
+
+    UpdateTrail(trail, { 0, 0 }, t0, settings);
+    UpdateTrail(trail, { 5, 0 }, t0 + 60ms, settings);
+    CHECK_EQ(trail.Size(), size_t(2));
+
+    // Samples survive fade + 50ms grace, then drop
+    ExpireTrail(trail, t0 + 100ms, settings);
+    CHECK_EQ(trail.Size(), size_t(2));
+    ExpireTrail(trail, t0 + 101ms, settings);
+    CHECK_EQ(trail.Size(), size_t(1));
+    ExpireTrail(trail, t0 + 161ms, settings);
+    CHECK(trail.Empty());
+}
+
+TEST(Trail, CapsAtMaxSize)
+{
+    TrailBuffer trail(kMaxTrailSize);
+    const TrailSettings settings;
+    const auto t0 = TrailClock::time_point{};
+
+    for (int i = 0; i < kMaxTrailSize + 20; ++i)
+        UpdateTrail(trail, { i, 0 }, t0, settings);
+    CHECK_EQ(trail.Size(), size_t(kMaxTrailSize));
+    CHECK_EQ(trail.Point(0).x, 20);
+}